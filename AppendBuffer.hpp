@@ -0,0 +1,197 @@
+//adi.gamzu@gmail.com
+
+
+#pragma once
+
+#include "MyContainer.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+
+namespace ariel {
+
+/**
+ * @brief Lock-free multi-producer append buffer that feeds a MyContainer.
+ *
+ * Producers call push()/emplace() from any number of threads. Each call claims a
+ * slot with one atomic fetch_add on a shared tail and constructs the element in a
+ * segmented array, so producers never wait for one another. publish() then moves
+ * everything claimed so far into a MyContainer in insertion (claim) order.
+ *
+ * Segments hold segment_size slots and live in a ring of ring_size entries. A
+ * drained segment is recycled, never freed, so a producer can never touch freed
+ * memory. Only when more than ring_size * segment_size elements are waiting for
+ * publish() does a producer have to wait for the ring slot it needs.
+ *
+ * @tparam T The type of elements stored in the buffer.
+ */
+template <typename T>
+class AppendBuffer {
+public:
+    static constexpr size_t segment_bits = 14;
+    static constexpr size_t segment_size = size_t(1) << segment_bits;
+    static constexpr size_t ring_size = 4096;
+
+private:
+    /// Slot states: not yet written, holds a live element, construction threw.
+    enum : unsigned char { empty = 0, filled = 1, abandoned = 2 };
+
+    struct Segment {
+        atomic<size_t> id;                 ///< Which segment number this memory currently serves.
+        atomic<unsigned char> state[segment_size];
+        T* items;
+
+        explicit Segment(size_t segment_id) : id(segment_id), items(allocator<T>().allocate(segment_size)) {
+            for (auto& s : state) s.store(empty, memory_order_relaxed);
+        }
+        ~Segment() { allocator<T>().deallocate(items, segment_size); }
+    };
+
+    /// Every producer does a fetch_add on tail, so it gets a cache line to itself:
+    /// neither publish() writing head nor producers reading ring may share it.
+    static constexpr size_t cache_line = 64;
+
+    alignas(cache_line) atomic<size_t> tail{0}; ///< Next slot to hand out.
+    alignas(cache_line) atomic<size_t> head{0}; ///< Next slot to publish (written by publish() only).
+    alignas(cache_line) atomic<Segment*> ring[ring_size] = {}; ///< Segment serving slot numbers k, k + ring_size, ...
+    std::mutex publish_mutex;              ///< One publisher at a time; producers never take it.
+
+    /**
+     * @brief Find (or create) the segment for segment number k.
+     *
+     * Waits only if the ring entry still serves segment k - ring_size, i.e. the
+     * buffer is a full ring ahead of the last publish().
+     */
+    Segment* segment_for(size_t k) {
+        atomic<Segment*>& entry = ring[k % ring_size];
+        Segment* seg = entry.load(memory_order_acquire);
+        if (!seg) {
+            auto fresh = make_unique<Segment>(k);
+            if (entry.compare_exchange_strong(seg, fresh.get(), memory_order_acq_rel)) {
+                return fresh.release();
+            }
+        }
+        while (seg->id.load(memory_order_acquire) != k) this_thread::yield();
+        return seg;
+    }
+
+public:
+    AppendBuffer() = default;
+    AppendBuffer(const AppendBuffer&) = delete;
+    AppendBuffer& operator=(const AppendBuffer&) = delete;
+
+    /**
+     * @brief Destroy unpublished elements and release every segment.
+     *
+     * No producer may still be running.
+     */
+    ~AppendBuffer() {
+        size_t end = tail.load(memory_order_acquire);
+        for (size_t slot = head.load(memory_order_relaxed); slot < end; ++slot) {
+            Segment* seg = ring[(slot >> segment_bits) % ring_size].load(memory_order_acquire);
+            size_t offset = slot & (segment_size - 1);
+            if (seg && seg->state[offset].load(memory_order_acquire) == filled) seg->items[offset].~T();
+        }
+        for (auto& entry : ring) delete entry.load(memory_order_acquire);
+    }
+
+
+    /**
+     * @brief Construct an element in the next free slot (lock-free, any thread).
+     * @param args Arguments forwarded to the constructor of T.
+     */
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        size_t slot = tail.fetch_add(1, memory_order_relaxed);
+        Segment* seg = segment_for(slot >> segment_bits);
+        size_t offset = slot & (segment_size - 1);
+        try {
+            ::new (static_cast<void*>(seg->items + offset)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            seg->state[offset].store(abandoned, memory_order_release);
+            throw;
+        }
+        seg->state[offset].store(filled, memory_order_release);
+    }
+
+
+    /**
+     * @brief Append a copy of an element (lock-free, any thread).
+     */
+    void push(const T& item) { emplace(item); }
+
+
+    /**
+     * @brief Append an element by moving it (lock-free, any thread).
+     */
+    void push(T&& item) { emplace(std::move(item)); }
+
+
+    /**
+     * @brief Number of slots claimed but not yet published (a snapshot).
+     *
+     * Safe to call from any thread, also while another thread publishes.
+     */
+    size_t pending() const {
+        size_t published = head.load(memory_order_acquire);  // first: tail never falls behind it
+        return tail.load(memory_order_acquire) - published;
+    }
+
+
+    /**
+     * @brief Move every element claimed so far into a container.
+     *
+     * Elements arrive in claim order, one add_range per contiguous run, so the
+     * target grows at most geometrically and keeps its sorted index up to date.
+     * Producers may keep pushing meanwhile; their new elements go to the next publish.
+     * @param target The container to append to.
+     * @return Number of elements moved into target.
+     */
+    template <typename Compare, typename Alloc>
+    size_t publish(MyContainer<T, Compare, Alloc>& target) {
+        std::lock_guard<std::mutex> guard(publish_mutex);
+        size_t end = tail.load(memory_order_acquire);
+        size_t next = head.load(memory_order_relaxed);
+        size_t moved = 0;
+        target.reserve(target.size() + (end - next));
+
+        while (next < end) {
+            size_t k = next >> segment_bits;
+            Segment* seg = ring[k % ring_size].load(memory_order_acquire);
+            while (!seg || seg->id.load(memory_order_acquire) != k) {
+                this_thread::yield();
+                seg = ring[k % ring_size].load(memory_order_acquire);
+            }
+            size_t first = next & (segment_size - 1);
+            size_t last = std::min(end - (k << segment_bits), segment_size);
+
+            size_t run = first;
+            for (size_t offset = first; offset < last; ++offset) {
+                unsigned char s;
+                while ((s = seg->state[offset].load(memory_order_acquire)) == empty) this_thread::yield();
+                if (s == abandoned) {
+                    target.add_range(make_move_iterator(seg->items + run), make_move_iterator(seg->items + offset));
+                    run = offset + 1;
+                }
+            }
+            target.add_range(make_move_iterator(seg->items + run), make_move_iterator(seg->items + last));
+
+            for (size_t offset = first; offset < last; ++offset) {
+                if (seg->state[offset].load(memory_order_relaxed) == filled) {
+                    seg->items[offset].~T();
+                    ++moved;
+                }
+                seg->state[offset].store(empty, memory_order_relaxed);
+            }
+            next = (k << segment_bits) + last;
+            head.store(next, memory_order_release);
+            if (last == segment_size) seg->id.store(k + ring_size, memory_order_release);
+        }
+        return moved;
+    }
+};
+
+}  // namespace ariel
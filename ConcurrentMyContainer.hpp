@@ -0,0 +1,242 @@
+//adi.gamzu@gmail.com
+
+
+#pragma once
+
+#include "MyContainer.hpp"
+
+#include <shared_mutex>
+
+namespace ariel {
+
+/**
+ * @brief Thread-safe wrapper around MyContainer with reader/writer locking.
+ *
+ * Mutations (add, remove, ...) take the lock exclusively and are serialized.
+ * Readers call read() to get a ReadView, which holds the lock shared for as long
+ * as it lives: any number of ReadViews can iterate at the same time, and every
+ * iterator obtained from one sees the same, unchanging contents. Keep views
+ * short-lived: the platform lock may favour readers, so an unbroken stream of
+ * overlapping views can hold writers off.
+ *
+ * @tparam T The type of elements stored in the container. Default is int.
+ * @tparam Compare Strict weak ordering used by the sorted orders. Default is std::less<T>.
+ * @tparam Alloc Allocator passed on to the wrapped MyContainer.
+ */
+template <typename T = int, typename Compare = std::less<T>, typename Alloc = std::allocator<T>>
+class ConcurrentMyContainer {
+private:
+    using Container = MyContainer<T, Compare, Alloc>;
+
+    mutable shared_mutex rw_mutex;   ///< Shared for ReadViews, exclusive for mutations.
+    Container container;             ///< The protected container.
+
+public:
+    /**
+     * @brief A consistent, read-only view of the container.
+     *
+     * Holds the shared lock until destroyed; writers wait until every view is gone.
+     * Iterators taken from a view must not outlive it.
+     */
+    class ReadView {
+    private:
+        shared_lock<shared_mutex> lock;
+        const ConcurrentMyContainer* owner;
+
+        const Container& contents() const { return owner->container; }
+
+    public:
+        explicit ReadView(const ConcurrentMyContainer& source)
+            : lock(source.rw_mutex), owner(&source) {}
+
+
+        /**
+         * @brief Get the number of elements in the snapshot.
+         */
+        size_t size() const { return owner->container.size(); }
+
+        typename Container::Order begin_order() const {
+            return contents().begin_order();
+        }
+        typename Container::Order end_order() const {
+            return contents().end_order();
+        }
+        typename Container::AscendingOrder begin_ascending_order() const {
+            return contents().begin_ascending_order();
+        }
+        typename Container::AscendingOrder end_ascending_order() const {
+            return contents().end_ascending_order();
+        }
+        typename Container::DescendingOrder begin_descending_order() const {
+            return contents().begin_descending_order();
+        }
+        typename Container::DescendingOrder end_descending_order() const {
+            return contents().end_descending_order();
+        }
+        typename Container::ReverseOrder begin_reverse_order() const {
+            return contents().begin_reverse_order();
+        }
+        typename Container::ReverseOrder end_reverse_order() const {
+            return contents().end_reverse_order();
+        }
+        typename Container::SideCrossOrder begin_side_cross_order() const {
+            return contents().begin_side_cross_order();
+        }
+        typename Container::SideCrossOrder end_side_cross_order() const {
+            return contents().end_side_cross_order();
+        }
+        typename Container::MiddleOutOrder begin_middle_out_order() const {
+            return contents().begin_middle_out_order();
+        }
+        typename Container::MiddleOutOrder end_middle_out_order() const {
+            return contents().end_middle_out_order();
+        }
+
+
+        /**
+         * @brief Print the snapshot using stream output.
+         */
+        friend ostream& operator<<(ostream& os, const ReadView& view) {
+            return os << view.contents();
+        }
+    };
+
+    ConcurrentMyContainer() = default;
+
+    /**
+     * @brief Construct an empty container ordered by a specific comparator object.
+     * @param comp The comparator used by the sorted orders.
+     * @param alloc The allocator for the elements and every internal buffer.
+     */
+    explicit ConcurrentMyContainer(const Compare& comp, const Alloc& alloc = Alloc()) : container(comp, alloc) {}
+
+    /**
+     * @brief Wrap an existing container, taking it over by move.
+     * @param initial The contents to start with.
+     */
+    explicit ConcurrentMyContainer(Container&& initial) : container(std::move(initial)) {}
+
+    ConcurrentMyContainer(const ConcurrentMyContainer&) = delete;
+    ConcurrentMyContainer& operator=(const ConcurrentMyContainer&) = delete;
+
+
+    /**
+     * @brief Take a consistent read-only view; blocks while a mutation is running.
+     * @return A view holding the shared lock.
+     */
+    ReadView read() const {
+        return ReadView(*this);
+    }
+
+
+    /**
+     * @brief Take a snapshot; the shared lock is held only while it is copied.
+     *
+     * Unlike a ReadView, a snapshot never blocks writers while it is being scanned,
+     * but taking one copies the elements (see MyContainer::snapshot()).
+     * @return An immutable copy of the contents in insertion order.
+     */
+    typename Container::Snapshot snapshot() const {
+        shared_lock<shared_mutex> lock(rw_mutex);
+        return container.snapshot();
+    }
+
+
+    /**
+     * @brief Get the number of elements.
+     */
+    size_t size() const {
+        shared_lock<shared_mutex> lock(rw_mutex);
+        return container.size();
+    }
+
+
+    /**
+     * @brief Add an element (exclusive).
+     */
+    void add(const T& item) {
+        unique_lock<shared_mutex> lock(rw_mutex);
+        container.add(item);
+    }
+
+
+    /**
+     * @brief Add an element by moving it in (exclusive).
+     */
+    void add(T&& item) {
+        unique_lock<shared_mutex> lock(rw_mutex);
+        container.add(std::move(item));
+    }
+
+
+    /**
+     * @brief Construct an element in place (exclusive).
+     */
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        unique_lock<shared_mutex> lock(rw_mutex);
+        container.emplace(std::forward<Args>(args)...);
+    }
+
+
+    /**
+     * @brief Add a whole range under a single exclusive lock.
+     */
+    template <typename InputIt>
+    void add_range(InputIt first, InputIt last) {
+        unique_lock<shared_mutex> lock(rw_mutex);
+        container.add_range(first, last);
+    }
+
+
+    /**
+     * @brief Remove all occurrences of an element (exclusive).
+     * @throws std::invalid_argument if the element does not exist in the container.
+     */
+    void remove(const T& item) {
+        unique_lock<shared_mutex> lock(rw_mutex);
+        container.remove(item);
+    }
+
+
+    /**
+     * @brief Remove every element matching a predicate (exclusive).
+     * @return Number of elements removed.
+     */
+    template <typename Predicate>
+    size_t remove_if(Predicate pred) {
+        unique_lock<shared_mutex> lock(rw_mutex);
+        return container.remove_if(pred);
+    }
+
+
+    /**
+     * @brief Remove all occurrences of every value in a range (exclusive).
+     * @return Number of elements removed.
+     */
+    template <typename Range>
+    size_t remove_all(const Range& values) {
+        unique_lock<shared_mutex> lock(rw_mutex);
+        return container.remove_all(values);
+    }
+
+
+    /**
+     * @brief Choose how many threads build the sorted views (exclusive).
+     */
+    void set_sort_threads(unsigned threads) {
+        unique_lock<shared_mutex> lock(rw_mutex);
+        container.set_sort_threads(threads);
+    }
+
+
+    /**
+     * @brief Switch stable ordering of the sorted views on or off (exclusive).
+     */
+    void set_stable_order(bool stable) {
+        unique_lock<shared_mutex> lock(rw_mutex);
+        container.set_stable_order(stable);
+    }
+};
+
+}  // namespace ariel
@@ -0,0 +1,158 @@
+//adi.gamzu@gmail.com
+
+
+#pragma once
+
+#include "MyContainer.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ariel {
+
+/**
+ * @brief Read-only container backed by a memory-mapped file written by MyContainer::save().
+ *
+ * Opening maps the file and checks its header; no element is read, so startup is
+ * O(1) regardless of size and pages are faulted in by the OS as they are touched.
+ * Elements are read in place, in insertion order. Use MyContainer::load() instead
+ * when the data must be modified or iterated in a sorted order.
+ *
+ * @tparam T The element type the file was saved with; must be trivially copyable.
+ */
+template <typename T = int>
+class MappedContainer {
+    static_assert(is_trivially_copyable_v<T>, "MappedContainer needs a trivially copyable T");
+    static_assert(sizeof(SaveHeader) % alignof(T) == 0, "elements would be misaligned after the header");
+
+private:
+    void* mapping = nullptr;  ///< Start of the mapped file.
+    size_t mapped_bytes = 0;  ///< Length of the mapping.
+    const T* elements = nullptr;
+    size_t count = 0;
+
+    /**
+     * @brief Throw a runtime_error for path that includes the current errno text.
+     */
+    [[noreturn]] static void fail(const string& path, const char* what) {
+        throw runtime_error(path + ": " + what + ": " + strerror(errno));
+    }
+
+    void unmap() {
+        if (mapping) munmap(mapping, mapped_bytes);
+        mapping = nullptr;
+        mapped_bytes = 0;
+        elements = nullptr;
+        count = 0;
+    }
+
+public:
+    MappedContainer() = default;
+
+    /**
+     * @brief Map a file for reading.
+     * @param path A file written by MyContainer<T>::save().
+     * @throws std::runtime_error if the file cannot be mapped, is malformed or truncated,
+     * or holds a different element type.
+     */
+    explicit MappedContainer(const string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) fail(path, "cannot open");
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            fail(path, "cannot stat");
+        }
+        size_t bytes = static_cast<size_t>(info.st_size);
+        if (bytes < sizeof(SaveHeader)) {
+            ::close(fd);
+            throw runtime_error(path + ": file too short for a header");
+        }
+        void* start = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (start == MAP_FAILED) fail(path, "cannot map");
+        mapping = start;
+        mapped_bytes = bytes;
+
+        try {
+            SaveHeader header;
+            memcpy(&header, mapping, sizeof(header));
+            check_save_header(header, save_raw, sizeof(T), path);
+            if ((bytes - sizeof(header)) / sizeof(T) < header.count) throw runtime_error(path + ": truncated");
+            elements = reinterpret_cast<const T*>(static_cast<const char*>(mapping) + sizeof(header));
+            count = static_cast<size_t>(header.count);
+        } catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    MappedContainer(const MappedContainer&) = delete;
+    MappedContainer& operator=(const MappedContainer&) = delete;
+
+    MappedContainer(MappedContainer&& other) noexcept
+        : mapping(other.mapping), mapped_bytes(other.mapped_bytes), elements(other.elements), count(other.count) {
+        other.mapping = nullptr;
+        other.unmap();
+    }
+
+    MappedContainer& operator=(MappedContainer&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            mapping = other.mapping;
+            mapped_bytes = other.mapped_bytes;
+            elements = other.elements;
+            count = other.count;
+            other.mapping = nullptr;
+            other.unmap();
+        }
+        return *this;
+    }
+
+    ~MappedContainer() { unmap(); }
+
+
+    /**
+     * @brief Get the number of elements in the file.
+     */
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief Element at insertion position pos; touching it may fault its page in.
+     * @throws std::out_of_range if pos >= size() (checked builds only).
+     */
+    const T& operator[](size_t pos) const {
+        if constexpr (checked_iterators) {
+            if (pos >= count) throw std::out_of_range("MappedContainer position out of range");
+        }
+        return elements[pos];
+    }
+
+    /**
+     * @brief The mapped elements as a contiguous array.
+     */
+    const T* data() const { return elements; }
+
+    const T* begin() const { return elements; }
+    const T* end() const { return elements + count; }
+
+
+    /**
+     * @brief Print the contents using stream output, like MyContainer.
+     */
+    friend ostream& operator<<(ostream& os, const MappedContainer& mapped) {
+        os << "{";
+        for (size_t i = 0; i < mapped.count; ++i) {
+            os << mapped.elements[i];
+            if (i < mapped.count - 1) os << ", ";
+        }
+        os << "}";
+        return os;
+    }
+};
+
+}  // namespace ariel
@@ -7,34 +7,687 @@
 #include <vector>
 #include <stdexcept>
 #include <algorithm>
+#include <numeric>
+#include <unordered_set>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <thread>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <atomic>
+#include <mutex>
+#include <fstream>
+#include <string>
+#if __cplusplus >= 202002L && __has_include(<ranges>)
+#include <ranges>
+#endif
+
+/**
+ * Iterator bounds checks are compiled in unless ARIEL_CHECKED_ITERATORS is 0.
+ * By default they follow NDEBUG: on in debug builds, off in release builds.
+ */
+#ifndef ARIEL_CHECKED_ITERATORS
+#ifdef NDEBUG
+#define ARIEL_CHECKED_ITERATORS 0
+#else
+#define ARIEL_CHECKED_ITERATORS 1
+#endif
+#endif
 
 using namespace std;
 
 namespace ariel {
 
+/// True when iterators test bounds and throw std::out_of_range on misuse.
+inline constexpr bool checked_iterators = ARIEL_CHECKED_ITERATORS != 0;
+
+/// True when a < b compiles for two const U.
+template <typename U, typename = void> struct has_less_than : false_type {};
+template <typename U>
+struct has_less_than<U, void_t<decltype(declval<const U&>() < declval<const U&>())>> : true_type {};
+
+/**
+ * @brief Header of the binary file written by MyContainer::save().
+ *
+ * Followed by the elements: count * element_size raw bytes for a trivially copyable
+ * T, or for strings a uint64_t length and the characters of each element. Integers
+ * are in the byte order of the machine that wrote the file. The header is 32 bytes,
+ * so raw elements start suitably aligned in a memory-mapped file.
+ */
+struct SaveHeader {
+    char magic[8];          ///< save_magic.
+    uint32_t version;       ///< save_format_version.
+    uint32_t encoding;      ///< save_raw or save_strings.
+    uint64_t element_size;  ///< sizeof(T) for raw elements, 1 for strings.
+    uint64_t count;         ///< Number of elements.
+};
+static_assert(sizeof(SaveHeader) == 32, "SaveHeader must have no padding");
+
+inline constexpr char save_magic[8] = {'A', 'R', 'I', 'E', 'L', 'M', 'C', '\0'};
+inline constexpr uint32_t save_format_version = 1;
+inline constexpr uint32_t save_raw = 0;
+inline constexpr uint32_t save_strings = 1;
+
+/// True for std::basic_string<char, ...>, including std::pmr::string.
+template <typename U> struct is_byte_string : false_type {};
+template <typename Traits, typename A> struct is_byte_string<basic_string<char, Traits, A>> : true_type {};
+
+/**
+ * @brief Check a header read from path against the expected encoding and element size.
+ * @throws std::runtime_error naming path and the first mismatch.
+ */
+inline void check_save_header(const SaveHeader& header, uint32_t encoding, uint64_t element_size,
+                              const string& path) {
+    if (memcmp(header.magic, save_magic, sizeof(save_magic)) != 0)
+        throw runtime_error(path + ": not a MyContainer file");
+    if (header.version != save_format_version)
+        throw runtime_error(path + ": unsupported format version " + to_string(header.version));
+    if (header.encoding != encoding || header.element_size != element_size)
+        throw runtime_error(path + ": element type does not match the file");
+}
+
+/**
+ * @brief A lightweight range over one iteration order: a begin/end iterator pair.
+ *
+ * The order is computed once, when the view is created, and copying the view copies
+ * two iterators. It works with range-for, and in C++20 it models
+ * std::ranges::random_access_range, view and borrowed_range, so it composes with
+ * std::views::take, filter and the rest. Like its iterators, a view is invalidated
+ * by any change to the container.
+ *
+ * @tparam Iterator One of MyContainer's order iterators.
+ */
+template <typename Iterator>
+class OrderView {
+private:
+    Iterator first;
+    Iterator last;
+
+public:
+    using iterator = Iterator;
+    using value_type = typename iterator_traits<Iterator>::value_type;
+    using reference = typename iterator_traits<Iterator>::reference;
+    using difference_type = typename iterator_traits<Iterator>::difference_type;
+
+    OrderView() = default;
+    OrderView(Iterator begin, Iterator end) : first(std::move(begin)), last(std::move(end)) {}
+
+    Iterator begin() const { return first; }
+    Iterator end() const { return last; }
+
+    /**
+     * @brief Number of elements in the view, in O(1).
+     */
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+
+    /**
+     * @brief The k-th element of this order, in O(1).
+     */
+    reference operator[](size_t k) const { return first[static_cast<difference_type>(k)]; }
+    reference front() const { return *first; }
+    reference back() const { return *(last - 1); }
+};
+
 /**
  * @brief A generic container class that supports multiple custom iteration orders.
  * 
  * @tparam T The type of elements stored in the container. Default is int.
+ * @tparam Compare Strict weak ordering used by the sorted orders. Default is std::less<T>.
+ * @tparam Alloc Allocator for the elements; rebound for every index and scratch buffer.
  */
-template <typename T = int>
+template <typename T = int, typename Compare = std::less<T>, typename Alloc = std::allocator<T>>
 class MyContainer {
 private:
-    vector<T> data; ///< Internal storage for elements.
+    using alloc_traits = allocator_traits<Alloc>;
+    template <typename U> using rebound = typename alloc_traits::template rebind_alloc<U>;
+    template <typename U> using buffer = vector<U, rebound<U>>;
+    using index_vector = buffer<size_t>;
+    using chunk = vector<T, Alloc>;
+
+    vector<T, Alloc> data; ///< Internal storage for elements.
+    Compare compare; ///< Ordering used by the ascending/descending/side-cross views.
+    mutable index_vector sorted_index; ///< Cached ascending permutation of positions into data.
+    mutable atomic<bool> sorted_valid{false}; ///< False until first needed, or after a bulk load too big to merge.
+    unsigned sort_thread_count = 1;      ///< Threads used to build the sorted index (1 = serial).
+    bool stable_ordering = false;        ///< Equal elements keep insertion order in sorted views.
+    mutable index_vector descending_index;   ///< Stable descending permutation (stable mode only).
+    mutable atomic<bool> descending_valid{false}; ///< False whenever the container changed.
+    mutable buffer<weak_ptr<const chunk>> snapshot_chunks; ///< Chunk copies of data, alive while a snapshot holds them.
+    mutable size_t snapshot_dirty_from = 0;  ///< First position changed since the chunks were copied (max = none).
+    size_t modification_epoch = 0;           ///< Bumped by every mutation in checked builds; iterators compare it.
+    mutable std::mutex cache_mutex;          ///< Serializes lazy builds of the caches above by concurrent readers.
+
+    /// Elements per snapshot chunk, as a power of two.
+    static constexpr size_t snapshot_chunk_bits = 12;
+    static constexpr size_t snapshot_chunk = size_t(1) << snapshot_chunk_bits;
+
+    /// Below this many elements per thread a parallel sort is not worth spawning for.
+    static constexpr size_t parallel_sort_grain = size_t(1) << 14;
+
+    /// True when the views use the natural operator< order of T.
+    static constexpr bool natural_order =
+        is_same_v<Compare, std::less<T>> || is_same_v<Compare, std::less<>>;
+
+    /// True when Compare can order two elements. std::less<T> is checked through
+    /// operator<, since its call operator is declared for any T.
+    static constexpr bool comparable = natural_order ? has_less_than<T>::value
+                                                     : is_invocable_r_v<bool, const Compare&, const T&, const T&>;
+
+    /// True when T can be ordered by an LSD radix sort on its bit pattern.
+    static constexpr bool radix_sortable = natural_order &&
+        ((is_integral_v<T> && sizeof(T) <= 8) ||
+         (is_floating_point_v<T> && numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8)));
+
+    /// Default for how soon a lazy traversal sorts the rest; see lazy_ascending().
+    static constexpr size_t lazy_sort_fraction = 32;
+
+    /// Length of the runs the stable sort insertion-sorts before merging.
+    static constexpr size_t stable_sort_run = 32;
+
+    /// Below this many elements the comparison sort wins over the radix passes.
+    static constexpr size_t radix_sort_min = 256;
+
+    using radix_key = conditional_t<(sizeof(T) <= 4), uint32_t, uint64_t>;
+
+    /**
+     * @brief The container's allocator, rebound to U, for an internal buffer.
+     */
+    template <typename U>
+    rebound<U> allocator_for() const {
+        return rebound<U>(data.get_allocator());
+    }
+
+    /**
+     * @brief Strict weak ordering of elements by Compare; in the natural order of a
+     * floating-point T, NaNs sort last.
+     */
+    bool value_less(const T& a, const T& b) const {
+        if constexpr (natural_order && is_floating_point_v<T>) {
+            return a < b || (b != b && a == a);
+        } else {
+            return compare(a, b);
+        }
+    }
+
+    /**
+     * @brief Map an element to an unsigned key whose natural order matches value_less.
+     *
+     * Signed integers get their sign bit flipped. IEEE floats flip every bit when
+     * negative and only the sign bit otherwise; NaNs map to the largest key and both
+     * zeros to the key of +0.0.
+     */
+    static radix_key radix_key_of(const T& value) {
+        constexpr radix_key sign = radix_key(1) << (sizeof(T) * 8 - 1);
+        if constexpr (is_floating_point_v<T>) {
+            if (value != value) return numeric_limits<radix_key>::max();
+            if (value == T(0)) return sign;  // -0.0 and +0.0 are equal under value_less
+            conditional_t<sizeof(T) == 4, uint32_t, uint64_t> raw;
+            memcpy(&raw, &value, sizeof(T));
+            radix_key bits = raw;
+            return (bits & sign) ? ~bits : (bits | sign);
+        } else if constexpr (is_signed_v<T>) {
+            return static_cast<radix_key>(static_cast<make_unsigned_t<T>>(value)) ^ sign;
+        } else {
+            return static_cast<radix_key>(value);
+        }
+    }
+
+    /**
+     * @brief Stable LSD radix sort of a range of positions, one byte per pass.
+     *
+     * Histograms for every byte are gathered in a single read; a pass whose byte is
+     * the same for all keys is skipped, so small integers need only one or two passes.
+     * With more than one sort thread the range is cut into one part per thread. Each
+     * part counts its own histogram and scatters its own keys into slots reserved
+     * after those of the parts before it, so the passes stay stable.
+     */
+    void radix_sort_positions(typename index_vector::iterator first, typename index_vector::iterator last) const {
+        constexpr size_t bytes = sizeof(T);
+        size_t n = static_cast<size_t>(last - first);
+        size_t parts = std::max<size_t>(1, std::min<size_t>(sort_thread_count, n / parallel_sort_grain));
+        buffer<radix_key> keys(n, allocator_for<radix_key>()), keys_scratch(n, allocator_for<radix_key>());
+        index_vector positions_scratch(n, allocator_for<size_t>());
+        index_vector counts(parts * bytes * 256, 0, allocator_for<size_t>());
+        index_vector bounds(parts + 1, allocator_for<size_t>());
+        for (size_t p = 0; p <= parts; ++p) bounds[p] = n * p / parts;
+
+        auto for_each_part = [&](auto&& work) {
+            if (parts == 1) {
+                work(size_t(0));
+                return;
+            }
+            buffer<thread> workers(allocator_for<thread>());
+            for (size_t p = 0; p < parts; ++p) workers.emplace_back([&work, p] { work(p); });
+            for (thread& worker : workers) worker.join();
+        };
+
+        for_each_part([&](size_t p) {
+            size_t* count = &counts[p * bytes * 256];
+            for (size_t i = bounds[p]; i < bounds[p + 1]; ++i) {
+                keys[i] = radix_key_of(data[first[i]]);
+                for (size_t b = 0; b < bytes; ++b) ++count[b * 256 + ((keys[i] >> (8 * b)) & 0xFF)];
+            }
+        });
+
+        radix_key* key_src = keys.data();
+        radix_key* key_dst = keys_scratch.data();
+        size_t* pos_src = &*first;
+        size_t* pos_dst = positions_scratch.data();
+        bool permuted = false;
+        for (size_t b = 0; b < bytes; ++b) {
+            auto count_of = [&](size_t p) { return &counts[p * bytes * 256 + b * 256]; };
+            size_t digit0 = (key_src[0] >> (8 * b)) & 0xFF, same = 0;
+            for (size_t p = 0; p < parts; ++p) same += count_of(p)[digit0];
+            if (same == n) continue;
+
+            // After a scatter the parts hold different keys than when they were counted.
+            if (parts > 1 && permuted) {
+                for_each_part([&](size_t p) {
+                    size_t* count = count_of(p);
+                    fill(count, count + 256, size_t(0));
+                    for (size_t i = bounds[p]; i < bounds[p + 1]; ++i) ++count[(key_src[i] >> (8 * b)) & 0xFF];
+                });
+            }
+            size_t offset = 0;
+            for (size_t d = 0; d < 256; ++d) {
+                for (size_t p = 0; p < parts; ++p) {
+                    size_t c = count_of(p)[d];
+                    count_of(p)[d] = offset;
+                    offset += c;
+                }
+            }
+            for_each_part([&](size_t p) {
+                size_t* count = count_of(p);
+                for (size_t i = bounds[p]; i < bounds[p + 1]; ++i) {
+                    size_t slot = count[(key_src[i] >> (8 * b)) & 0xFF]++;
+                    key_dst[slot] = key_src[i];
+                    pos_dst[slot] = pos_src[i];
+                }
+            });
+            std::swap(key_src, key_dst);
+            std::swap(pos_src, pos_dst);
+            permuted = true;
+        }
+        if (pos_src != &*first) copy(pos_src, pos_src + n, first);
+    }
+
+    /**
+     * @brief Get the ascending permutation of data, sorting only if it is stale.
+     *
+     * Safe to call from many threads on a const container: the first caller builds
+     * the index under cache_mutex, the others wait and then share it.
+     * @return Positions into data ordered from smallest to largest element.
+     */
+    const index_vector& ascending_index() const {
+        if (!sorted_valid.load(memory_order_acquire)) {
+            std::lock_guard<std::mutex> guard(cache_mutex);
+            if (!sorted_valid.load(memory_order_relaxed)) {
+                sorted_index.resize(data.size());
+                iota(sorted_index.begin(), sorted_index.end(), size_t(0));
+                sort_positions(sorted_index.begin(), sorted_index.end());
+                sorted_valid.store(true, memory_order_release);
+            }
+        }
+        return sorted_index;
+    }
+
+    /**
+     * @brief Get the stable descending permutation, deriving it if it is stale.
+     *
+     * Built in one O(n) pass over the stable ascending index: runs of equal elements
+     * are emitted from the largest run to the smallest, each run in its original
+     * (insertion) order. No second sort and no separate reverse pass.
+     * @return Positions into data ordered from largest to smallest element.
+     */
+    const index_vector& descending_view() const {
+        if (!descending_valid.load(memory_order_acquire)) {
+            const index_vector& asc = ascending_index();
+            std::lock_guard<std::mutex> guard(cache_mutex);
+            if (descending_valid.load(memory_order_relaxed)) return descending_index;
+            descending_index.resize(asc.size());
+            size_t out = 0, run_end = asc.size();
+            while (run_end > 0) {
+                size_t run_begin = run_end - 1;
+                while (run_begin > 0 && !value_less(data[asc[run_begin - 1]], data[asc[run_end - 1]]))
+                    --run_begin;
+                copy(asc.begin() + run_begin, asc.begin() + run_end, descending_index.begin() + out);
+                out += run_end - run_begin;
+                run_end = run_begin;
+            }
+            descending_valid.store(true, memory_order_release);
+        }
+        return descending_index;
+    }
+
+    /**
+     * @brief Comparator over positions into data, ordering by element value.
+     */
+    auto position_less() const {
+        return [this](size_t a, size_t b) { return value_less(data[a], data[b]); };
+    }
+
+    /**
+     * @brief Stable merge of the adjacent sorted runs [first, mid) and [mid, last).
+     *
+     * Like std::inplace_merge, but the shorter run is moved out into scratch, which
+     * must hold at least that many assignable elements. Never allocates.
+     */
+    template <typename It, typename Scratch, typename Less>
+    static void merge_runs(It first, It mid, It last, Scratch scratch, Less less) {
+        if (first == mid || mid == last) return;
+        if (mid - first <= last - mid) {
+            Scratch a = scratch, a_end = std::move(first, mid, scratch);
+            It b = mid, out = first;
+            while (a != a_end && b != last) *out++ = less(*b, *a) ? std::move(*b++) : std::move(*a++);
+            std::move(a, a_end, out);
+        } else {
+            Scratch b_begin = scratch, b = std::move(mid, last, scratch);
+            It a = mid, out = last;
+            while (b != b_begin && a != first) *--out = less(*(b - 1), *(a - 1)) ? std::move(*--a) : std::move(*--b);
+            std::move_backward(b_begin, b, out);
+        }
+    }
+
+    /**
+     * @brief merge_runs() with scratch space taken from the container's allocator.
+     */
+    template <typename It, typename Less>
+    void merge_runs(It first, It mid, It last, Less less) const {
+        using V = typename iterator_traits<It>::value_type;
+        It shorter = (mid - first <= last - mid) ? first : mid;
+        buffer<V> scratch(shorter, shorter + std::min(mid - first, last - mid), allocator_for<V>());
+        merge_runs(first, mid, last, scratch.begin(), less);
+    }
+
+    /**
+     * @brief Stable sort into scratch space of last - first assignable elements.
+     *
+     * Insertion-sorts short runs, then merges them bottom-up, alternating between the
+     * range and scratch. Never allocates.
+     */
+    template <typename It, typename Scratch, typename Less>
+    static void stable_sort_runs(It first, It last, Scratch scratch, Less less) {
+        using V = typename iterator_traits<It>::value_type;
+        size_t n = static_cast<size_t>(last - first);
+        for (size_t lo = 0; lo < n; lo += stable_sort_run) {
+            It run_first = first + lo, run_last = first + std::min(lo + stable_sort_run, n);
+            for (It i = run_first + (run_first != run_last); i < run_last; ++i) {
+                V value = std::move(*i);
+                It j = i;
+                for (; j != run_first && less(value, *(j - 1)); --j) *j = std::move(*(j - 1));
+                *j = std::move(value);
+            }
+        }
+
+        auto merge_pass = [n, &less](auto src, auto dst, size_t width) {
+            for (size_t lo = 0; lo < n; lo += 2 * width) {
+                size_t mid = std::min(lo + width, n), hi = std::min(lo + 2 * width, n);
+                std::merge(make_move_iterator(src + lo), make_move_iterator(src + mid),
+                           make_move_iterator(src + mid), make_move_iterator(src + hi), dst + lo, less);
+            }
+        };
+        bool in_scratch = false;
+        for (size_t width = stable_sort_run; width < n; width *= 2) {
+            if (in_scratch) merge_pass(scratch, first, width);
+            else merge_pass(first, scratch, width);
+            in_scratch = !in_scratch;
+        }
+        if (in_scratch) std::move(scratch, scratch + static_cast<ptrdiff_t>(n), first);
+    }
+
+    /**
+     * @brief Stable sort whose scratch space comes from the container's allocator.
+     *
+     * std::stable_sort would take that buffer from global operator new and bypass an
+     * arena or pool allocator.
+     */
+    template <typename It, typename Less>
+    void stable_sort_runs(It first, It last, Less less) const {
+        using V = typename iterator_traits<It>::value_type;
+        buffer<V> scratch(allocator_for<V>());
+        if (static_cast<size_t>(last - first) > stable_sort_run) scratch.assign(first, last);
+        stable_sort_runs(first, last, scratch.begin(), less);
+    }
+
+    /**
+     * @brief Sort a range of positions by element value, in parallel when enabled.
+     *
+     * Integral and IEEE floating-point element types take the O(n) radix path, whose
+     * passes are split across the sort threads. Otherwise, with more than one sort
+     * thread the range is cut into one run per thread, the runs are sorted
+     * concurrently, and adjacent runs are then merged pairwise, each level of merges
+     * also running concurrently.
+     */
+    void sort_positions(typename index_vector::iterator first, typename index_vector::iterator last) const {
+        size_t n = static_cast<size_t>(last - first);
+        if constexpr (radix_sortable) {
+            if (n >= radix_sort_min) {
+                radix_sort_positions(first, last);
+                return;
+            }
+        }
+        size_t runs = std::min<size_t>(sort_thread_count, n / parallel_sort_grain);
+        if (runs <= 1) {
+            if (stable_ordering) stable_sort_runs(first, last, position_less());
+            else sort(first, last, position_less());
+            return;
+        }
+
+        index_vector bounds(runs + 1, allocator_for<size_t>());
+        for (size_t i = 0; i <= runs; ++i) bounds[i] = n * i / runs;
+        // Allocated here, not in the workers: the allocator need not be thread-safe.
+        index_vector scratch(n, allocator_for<size_t>());
+
+        buffer<thread> workers(allocator_for<thread>());
+        for (size_t i = 0; i < runs; ++i) {
+            workers.emplace_back([this, first, &bounds, &scratch, i] {
+                auto lo = first + bounds[i], hi = first + bounds[i + 1];
+                if (stable_ordering) stable_sort_runs(lo, hi, scratch.begin() + bounds[i], position_less());
+                else sort(lo, hi, position_less());
+            });
+        }
+        for (thread& worker : workers) worker.join();
+
+        for (size_t width = 1; width < runs; width *= 2) {
+            workers.clear();
+            for (size_t i = 0; i + width < runs; i += 2 * width) {
+                auto lo = first + bounds[i];
+                auto mid = first + bounds[i + width];
+                auto hi = first + bounds[std::min(i + 2 * width, runs)];
+                auto slice = scratch.begin() + bounds[i];
+                workers.emplace_back([this, lo, mid, hi, slice] { merge_runs(lo, mid, hi, slice, position_less()); });
+            }
+            for (thread& worker : workers) worker.join();
+        }
+    }
+
+    /**
+     * @brief Strict order of positions along the ascending (or descending) traversal.
+     *
+     * In stable mode ties are broken by position, which reproduces the insertion order
+     * of the full stable views.
+     */
+    auto traversal_before(bool descending) const {
+        return [this, descending](size_t a, size_t b) {
+            const T& x = data[descending ? b : a];
+            const T& y = data[descending ? a : b];
+            if (value_less(x, y)) return true;
+            return stable_ordering && !value_less(y, x) && a < b;
+        };
+    }
+
+    /**
+     * @brief Positions of the first k elements of the ascending (or descending) order.
+     *
+     * A cached index is sliced in O(k). Otherwise nth_element selects the k winners and
+     * only those are sorted: O(n + k log k).
+     */
+    index_vector first_k_positions(size_t k, bool descending) const {
+        k = std::min(k, data.size());
+        index_vector chosen(allocator_for<size_t>());
+        if (sorted_valid.load(memory_order_acquire) && !(descending && stable_ordering)) {
+            if (descending) chosen.assign(sorted_index.rbegin(), sorted_index.rbegin() + k);
+            else chosen.assign(sorted_index.begin(), sorted_index.begin() + k);
+            return chosen;
+        }
+        chosen.resize(data.size());
+        iota(chosen.begin(), chosen.end(), size_t(0));
+        auto before = traversal_before(descending);
+        if (k < chosen.size()) nth_element(chosen.begin(), chosen.begin() + k, chosen.end(), before);
+        sort(chosen.begin(), chosen.begin() + k, before);
+        chosen.resize(k);
+        return chosen;
+    }
+
+    /**
+     * @brief Copy other's cached views, holding its cache lock so concurrent readers of
+     * other cannot be building them meanwhile.
+     *
+     * Snapshot chunks are shared, unless they live in memory from a different allocator.
+     * Buffers keep this container's allocator.
+     */
+    void copy_caches(const MyContainer& other) {
+        std::lock_guard<std::mutex> guard(other.cache_mutex);
+        sorted_index.assign(other.sorted_index.begin(), other.sorted_index.end());
+        sorted_valid.store(other.sorted_valid.load(memory_order_relaxed), memory_order_relaxed);
+        descending_index.assign(other.descending_index.begin(), other.descending_index.end());
+        descending_valid.store(other.descending_valid.load(memory_order_relaxed), memory_order_relaxed);
+        if (data.get_allocator() == other.data.get_allocator()) {
+            snapshot_chunks.assign(other.snapshot_chunks.begin(), other.snapshot_chunks.end());
+            snapshot_dirty_from = other.snapshot_dirty_from;
+        } else {
+            snapshot_chunks.clear();
+            snapshot_dirty_from = 0;
+        }
+    }
+
+    /**
+     * @brief Invalidate every outstanding iterator (checked builds only; a no-op otherwise).
+     */
+    void bump_epoch() {
+        if constexpr (checked_iterators) ++modification_epoch;
+    }
+
+    /**
+     * @brief Record that data changed at position pos or later.
+     *
+     * Drops the stable descending view and marks the snapshot chunks from pos on as
+     * stale; chunks before pos stay shared with existing snapshots.
+     */
+    void data_changed_from(size_t pos) {
+        bump_epoch();
+        descending_valid = false;
+        snapshot_dirty_from = std::min(snapshot_dirty_from, pos);
+    }
+
+    /**
+     * @brief Keep the sorted index in step after elements were appended to data.
+     *
+     * A single append is placed by binary search; a small batch is sorted on its own
+     * and merged in. A batch larger than what was already indexed drops the index
+     * instead, so the next scan does one full sort. Without a usable Compare (a T
+     * sorted only through projections) there is never an index to keep, and adding
+     * must not require one.
+     * @param old_size Size of data before the append.
+     */
+    void index_appended(size_t old_size) {
+        data_changed_from(old_size);
+        if constexpr (comparable) {
+            if (!sorted_valid) return;
+            size_t added = data.size() - old_size;
+            if (added == 1) {
+                auto at = upper_bound(sorted_index.begin(), sorted_index.end(), old_size, position_less());
+                sorted_index.insert(at, old_size);
+            } else if (added > old_size) {
+                sorted_valid = false;
+            } else if (added > 0) {
+                size_t mid = sorted_index.size();
+                sorted_index.resize(data.size());
+                iota(sorted_index.begin() + mid, sorted_index.end(), old_size);
+                sort_positions(sorted_index.begin() + mid, sorted_index.end());
+                merge_runs(sorted_index.begin(), sorted_index.begin() + mid, sorted_index.end(), position_less());
+            }
+        }
+    }
 
 public:
     // Forward declarations for iterator classes
+    template <typename Derived> class OrderIterator;
     class Order;
     class AscendingOrder;
     class DescendingOrder;
     class SideCrossOrder;
     class ReverseOrder;
     class MiddleOutOrder;
+    class ProjectedOrder;
+    class LazySortedOrder;
+    struct LazyState;
+    class Snapshot;
+
+    MyContainer() : MyContainer(Compare()) {}
+
+    /**
+     * @brief Construct an empty container ordered by a specific comparator object.
+     * @param comp The comparator used by the sorted orders.
+     * @param alloc The allocator for the elements and every internal buffer.
+     */
+    explicit MyContainer(const Compare& comp, const Alloc& alloc = Alloc())
+        : data(alloc), compare(comp), sorted_index(rebound<size_t>(alloc)),
+          descending_index(rebound<size_t>(alloc)), snapshot_chunks(rebound<weak_ptr<const chunk>>(alloc)) {}
 
-    MyContainer() = default;
-    MyContainer(const MyContainer& other) : data(other.data) {}
+    /**
+     * @brief Construct an empty container that allocates from alloc.
+     * @param alloc The allocator, e.g. a std::pmr::polymorphic_allocator over an arena.
+     */
+    explicit MyContainer(const Alloc& alloc) : MyContainer(Compare(), alloc) {}
+
+    /**
+     * @brief Copy another container into memory from a specific allocator.
+     * @param other The container to copy from.
+     * @param alloc The allocator for the copy.
+     */
+    MyContainer(const MyContainer& other, const Alloc& alloc)
+        : data(other.data, alloc), compare(other.compare), sorted_index(rebound<size_t>(alloc)),
+          sort_thread_count(other.sort_thread_count), stable_ordering(other.stable_ordering),
+          descending_index(rebound<size_t>(alloc)), snapshot_chunks(rebound<weak_ptr<const chunk>>(alloc)) {
+        copy_caches(other);
+    }
+
+    MyContainer(const MyContainer& other)
+        : data(other.data), compare(other.compare), sorted_index(allocator_for<size_t>()),
+          sort_thread_count(other.sort_thread_count), stable_ordering(other.stable_ordering),
+          descending_index(allocator_for<size_t>()), snapshot_chunks(allocator_for<weak_ptr<const chunk>>()) {
+        copy_caches(other);
+    }
     ~MyContainer() = default;
 
+    /**
+     * @brief Move constructor. Steals the storage and cached order in O(1).
+     * @param other The container to move from; left empty.
+     */
+    MyContainer(MyContainer&& other) noexcept(is_nothrow_move_constructible_v<Compare>)
+        : data(std::move(other.data)), compare(std::move(other.compare)),
+          sorted_index(std::move(other.sorted_index)),
+          sorted_valid(other.sorted_valid.load()), sort_thread_count(other.sort_thread_count),
+          stable_ordering(other.stable_ordering), descending_index(std::move(other.descending_index)),
+          descending_valid(other.descending_valid.load()), snapshot_chunks(std::move(other.snapshot_chunks)),
+          snapshot_dirty_from(other.snapshot_dirty_from) {
+        other.data.clear();
+        other.sorted_index.clear();
+        other.sorted_valid = false;
+        other.descending_index.clear();
+        other.descending_valid = false;
+        other.snapshot_chunks.clear();
+        other.snapshot_dirty_from = 0;
+        other.bump_epoch();
+    }
+
     
         /**
          * @brief Copy assignment operator.
@@ -44,11 +697,90 @@ public:
         MyContainer& operator=(const MyContainer& other) {
         if (this != &other) {
             data = other.data;
+            compare = other.compare;
+            sort_thread_count = other.sort_thread_count;
+            stable_ordering = other.stable_ordering;
+            copy_caches(other);
+            bump_epoch();
+        }
+        return *this;
+    }
+
+    
+        /**
+         * @brief Move assignment operator.
+         * @param other The container to move from; left empty.
+         * @return Reference to this container.
+         */
+        MyContainer& operator=(MyContainer&& other) noexcept(
+            is_nothrow_move_assignable_v<Compare> &&
+            (alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value)) {
+        if (this != &other) {
+            data = std::move(other.data);
+            compare = std::move(other.compare);
+            sorted_index = std::move(other.sorted_index);
+            sorted_valid = other.sorted_valid.load();
+            sort_thread_count = other.sort_thread_count;
+            stable_ordering = other.stable_ordering;
+            descending_index = std::move(other.descending_index);
+            descending_valid = other.descending_valid.load();
+            snapshot_chunks = std::move(other.snapshot_chunks);
+            snapshot_dirty_from = other.snapshot_dirty_from;
+            if (!(data.get_allocator() == other.data.get_allocator())) {
+                snapshot_chunks.clear();
+                snapshot_dirty_from = 0;
+            }
+            other.data.clear();
+            other.sorted_index.clear();
+            other.sorted_valid = false;
+            other.descending_index.clear();
+            other.descending_valid = false;
+            other.snapshot_chunks.clear();
+            other.snapshot_dirty_from = 0;
+            bump_epoch();
+            other.bump_epoch();
         }
         return *this;
     }
 
     
+        /**
+         * @brief Exchange contents with another container in O(1).
+         * @param other The container to swap with.
+         */
+        void swap(MyContainer& other) noexcept(is_nothrow_swappable_v<Compare>) {
+        using std::swap;
+        swap(data, other.data);
+        swap(compare, other.compare);
+        swap(sorted_index, other.sorted_index);
+        sorted_valid = other.sorted_valid.exchange(sorted_valid);
+        swap(sort_thread_count, other.sort_thread_count);
+        swap(stable_ordering, other.stable_ordering);
+        swap(descending_index, other.descending_index);
+        descending_valid = other.descending_valid.exchange(descending_valid);
+        swap(snapshot_chunks, other.snapshot_chunks);
+        swap(snapshot_dirty_from, other.snapshot_dirty_from);
+        bump_epoch();
+        other.bump_epoch();
+    }
+
+    
+        /**
+         * @brief Non-member swap, found by argument-dependent lookup.
+         */
+        friend void swap(MyContainer& a, MyContainer& b) noexcept(noexcept(a.swap(b))) {
+        a.swap(b);
+    }
+
+    
+        /**
+         * @brief Get a copy of the allocator used for the elements.
+         */
+        Alloc get_allocator() const {
+        return data.get_allocator();
+    }
+
+    
         /**
          * @brief Get the number of elements in the container.
          * @return Number of elements currently stored.
@@ -58,12 +790,114 @@ public:
     }
 
     
+        /**
+         * @brief Choose how many threads build the ascending/descending views.
+         *
+         * Sorting stays serial until each thread would get a sizeable run, so small
+         * containers are unaffected by this setting.
+         * @param threads 1 for a serial sort (the default), 0 for one per hardware thread.
+         */
+        void set_sort_threads(unsigned threads) {
+        if (threads == 0) threads = std::max(1u, thread::hardware_concurrency());
+        sort_thread_count = threads;
+    }
+
+    
+        /**
+         * @brief Make sorted views deterministic for equal elements.
+         *
+         * In stable mode equal elements keep insertion order in the ascending,
+         * descending and side-cross views. The descending view then gets its own
+         * permutation, derived from the ascending one in a single linear pass.
+         * @param stable True for stable ordering; false (the default) allows any order among ties.
+         */
+        void set_stable_order(bool stable) {
+        if (stable != stable_ordering) {
+            stable_ordering = stable;
+            bump_epoch();
+            sorted_valid = false;
+            descending_valid = false;
+        }
+    }
+
+    
+        /**
+         * @brief Check whether sorted views keep insertion order among equal elements.
+         * @return True in stable mode.
+         */
+        bool stable_order() const {
+        return stable_ordering;
+    }
+
+    
+        /**
+         * @brief Get the number of threads used to build the sorted views.
+         * @return Thread count; 1 means serial.
+         */
+        unsigned sort_threads() const {
+        return sort_thread_count;
+    }
+
+    
         /**
          * @brief Add an element to the container.
          * @param item The element to add.
          */
         void add(const T& item) {
         data.push_back(item);
+        index_appended(data.size() - 1);
+    }
+
+    
+        /**
+         * @brief Add an element by moving it into the container.
+         * @param item The element to move in; left in a valid but unspecified state.
+         */
+        void add(T&& item) {
+        data.push_back(std::move(item));
+        index_appended(data.size() - 1);
+    }
+
+    
+        /**
+         * @brief Construct an element in place at the end of the container.
+         * @param args Arguments forwarded to the constructor of T.
+         */
+        template <typename... Args>
+        void emplace(Args&&... args) {
+        data.emplace_back(std::forward<Args>(args)...);
+        index_appended(data.size() - 1);
+    }
+
+    
+        /**
+         * @brief Reserve storage for at least n elements.
+         * @param n The capacity to reserve.
+         */
+        void reserve(size_t n) {
+        data.reserve(n);
+    }
+
+    
+        /**
+         * @brief Add every element of [first, last), growing storage at most once.
+         *
+         * When the range size is known up front, capacity is grown geometrically in a
+         * single step so that repeated calls keep O(log n) total reallocations.
+         * Pass move iterators to move the elements instead of copying them.
+         * @param first Beginning of the input range.
+         * @param last End of the input range.
+         */
+        template <typename InputIt>
+        void add_range(InputIt first, InputIt last) {
+        size_t old_size = data.size();
+        using Category = typename iterator_traits<InputIt>::iterator_category;
+        if constexpr (is_base_of_v<forward_iterator_tag, Category>) {
+            size_t needed = data.size() + static_cast<size_t>(std::distance(first, last));
+            if (needed > data.capacity()) data.reserve(std::max(needed, 2 * data.capacity()));
+        }
+        data.insert(data.end(), first, last);
+        index_appended(old_size);
     }
 
     
@@ -73,17 +907,162 @@ public:
          * @throws std::invalid_argument if the element does not exist in the container.
          */
         void remove(const T& item) {
-        bool removed = false;
+        if (remove_if([&item](const T& value) { return value == item; }) == 0) {
+            throw std::invalid_argument("ERROR: Object does not exist\n");
+        }
+    }
+
+    
+        /**
+         * @brief Remove every element matching a predicate in one compacting pass.
+         *
+         * If the sorted index is built, the removed entries are dropped from it and the
+         * survivors renumbered in the same O(n) pass, so no re-sort is needed.
+         * @param pred Unary predicate returning true for elements to drop.
+         * @return Number of elements removed (0 is not an error).
+         */
+        template <typename Predicate>
+        size_t remove_if(Predicate pred) {
+        if (!sorted_valid) {
+            auto first = std::find_if(data.begin(), data.end(), pred);
+            if (first == data.end()) return 0;
+            data_changed_from(static_cast<size_t>(first - data.begin()));
+            auto new_end = first;
+            for (auto it = std::next(first); it != data.end(); ++it) {
+                if (!pred(*it)) *new_end++ = std::move(*it);
+            }
+            size_t removed = static_cast<size_t>(data.end() - new_end);
+            data.erase(new_end, data.end());
+            return removed;
+        }
+
+        const size_t gone = data.size();
+        index_vector new_position(data.size(), allocator_for<size_t>());
+        size_t kept = 0;
         for (size_t i = 0; i < data.size(); ++i) {
-            if (data[i] == item) {
-                data.erase(data.begin() + i);
-                --i;
-                removed = true;
+            if (pred(data[i])) {
+                if (kept == i) data_changed_from(i);
+                new_position[i] = gone;
+            } else {
+                if (kept != i) data[kept] = std::move(data[i]);
+                new_position[i] = kept++;
             }
         }
-        if (!removed) {
-            throw std::invalid_argument("ERROR: Object does not exist\n");
+        size_t removed = data.size() - kept;
+        if (removed > 0) {
+            data.erase(data.begin() + kept, data.end());
+            size_t out = 0;
+            for (size_t pos : sorted_index) {
+                if (new_position[pos] != gone) sorted_index[out++] = new_position[pos];
+            }
+            sorted_index.resize(out);
+        }
+        return removed;
+    }
+
+    
+        /**
+         * @brief Remove all occurrences of every value in a range, in one O(n) sweep.
+         * @param values Any iterable of values; they are hashed into a lookup set first.
+         * @return Number of elements removed (0 is not an error).
+         */
+        template <typename Range>
+        size_t remove_all(const Range& values) {
+        unordered_set<T, hash<T>, equal_to<T>, rebound<T>> doomed(
+            std::begin(values), std::end(values), 0, hash<T>(), equal_to<T>(), allocator_for<T>());
+        if (doomed.empty()) return 0;
+        return remove_if([&doomed](const T& value) { return doomed.count(value) != 0; });
+    }
+
+    
+        /**
+         * @brief Write the elements, in insertion order, to a binary file.
+         *
+         * T must be trivially copyable (written as raw bytes, one write call) or a
+         * std::string (each element length-prefixed). Cached views are not saved.
+         * @param path The file to create or overwrite.
+         * @throws std::runtime_error if the file cannot be written.
+         */
+        void save(const string& path) const {
+        static_assert(is_trivially_copyable_v<T> || is_byte_string<T>::value,
+                      "save() needs a trivially copyable T or a std::string");
+        ofstream out(path, ios::binary | ios::trunc);
+        if (!out) throw runtime_error(path + ": cannot open for writing");
+        SaveHeader header{};
+        memcpy(header.magic, save_magic, sizeof(save_magic));
+        header.version = save_format_version;
+        header.count = data.size();
+        if constexpr (is_byte_string<T>::value) {
+            header.encoding = save_strings;
+            header.element_size = 1;
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (const T& item : data) {
+                uint64_t length = item.size();
+                out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+                out.write(item.data(), static_cast<streamsize>(length));
+            }
+        } else {
+            header.encoding = save_raw;
+            header.element_size = sizeof(T);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(data.data()), static_cast<streamsize>(data.size() * sizeof(T)));
         }
+        out.flush();
+        if (!out) throw runtime_error(path + ": write failed");
+    }
+
+    
+        /**
+         * @brief Replace the contents with the elements of a file written by save().
+         *
+         * Raw elements are read with a single read call into the final storage. The
+         * comparator and settings are kept; sorted views are rebuilt on next use. On
+         * error the container is left unchanged.
+         * @param path The file to read.
+         * @throws std::runtime_error if the file is missing, malformed, truncated, or
+         * holds a different element type.
+         */
+        void load(const string& path) {
+        static_assert(is_trivially_copyable_v<T> || is_byte_string<T>::value,
+                      "load() needs a trivially copyable T or a std::string");
+        ifstream in(path, ios::binary);
+        if (!in) throw runtime_error(path + ": cannot open for reading");
+        SaveHeader header{};
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            throw runtime_error(path + ": file too short for a header");
+        // Every size read from the file is checked against what is left of it before
+        // anything is allocated, so a corrupt count or length cannot exhaust memory.
+        in.seekg(0, ios::end);
+        uint64_t remaining = static_cast<uint64_t>(in.tellg()) - sizeof(header);
+        in.seekg(sizeof(header));
+
+        vector<T, Alloc> loaded(data.get_allocator());
+        if constexpr (is_byte_string<T>::value) {
+            check_save_header(header, save_strings, 1, path);
+            if (remaining / sizeof(uint64_t) < header.count) throw runtime_error(path + ": truncated");
+            loaded.reserve(header.count);
+            for (uint64_t i = 0; i < header.count; ++i) {
+                uint64_t length = 0;
+                if (!in.read(reinterpret_cast<char*>(&length), sizeof(length)))
+                    throw runtime_error(path + ": truncated");
+                remaining -= sizeof(length);
+                if (length > remaining) throw runtime_error(path + ": truncated");
+                remaining -= length;
+                loaded.emplace_back(length, '\0');
+                if (!in.read(loaded.back().data(), static_cast<streamsize>(length)))
+                    throw runtime_error(path + ": truncated");
+            }
+        } else {
+            check_save_header(header, save_raw, sizeof(T), path);
+            if (remaining / sizeof(T) < header.count) throw runtime_error(path + ": truncated");
+            loaded.resize(header.count);
+            if (!in.read(reinterpret_cast<char*>(loaded.data()), static_cast<streamsize>(header.count * sizeof(T))))
+                throw runtime_error(path + ": truncated");
+        }
+
+        data.swap(loaded);
+        sorted_valid = false;
+        data_changed_from(0);
     }
 
     
@@ -93,7 +1072,7 @@ public:
          * @param container The container to print.
          * @return Reference to the output stream.
          */
-        friend ostream& operator<<(ostream& os, const MyContainer<T>& container) {
+        friend ostream& operator<<(ostream& os, const MyContainer& container) {
         os << "{";
         for (size_t i = 0; i < container.size(); ++i) {
             os << container.data[i];
@@ -103,209 +1082,405 @@ public:
         return os;
     }
 
+    
+        /**
+         * @brief Take an immutable copy of the current contents, stored in shared chunks.
+         *
+         * This is not copy-on-write: the live elements stay in one contiguous vector, so
+         * taking a snapshot copies them, and writers never copy anything. Snapshots taken
+         * while an earlier one is alive share its chunks, and only chunks at or after the
+         * first position changed in between are copied again; overlapping snapshots of a
+         * container that mostly grows at the end cost O(changed elements). A snapshot
+         * taken when no earlier one is alive copies all n elements. A snapshot never sees
+         * later add/remove calls and stays valid after the container is destroyed.
+         *
+         * The container only keeps weak references to the chunks, so their memory is
+         * freed with the last snapshot using them.
+         * @return A snapshot of the elements in insertion order.
+         */
+        Snapshot snapshot() const {
+        std::lock_guard<std::mutex> guard(cache_mutex);
+        size_t keep = std::min(snapshot_chunks.size(), snapshot_dirty_from >> snapshot_chunk_bits);
+        snapshot_chunks.resize(keep);
+        buffer<shared_ptr<const chunk>> parts(allocator_for<shared_ptr<const chunk>>());
+        parts.reserve((data.size() + snapshot_chunk - 1) >> snapshot_chunk_bits);
+        for (size_t start = 0; start < data.size(); start += snapshot_chunk) {
+            size_t i = start >> snapshot_chunk_bits;
+            shared_ptr<const chunk> shared = i < keep ? snapshot_chunks[i].lock() : nullptr;
+            if (!shared) {
+                size_t stop = std::min(start + snapshot_chunk, data.size());
+                chunk part(data.begin() + start, data.begin() + stop, data.get_allocator());
+                shared = allocate_shared<chunk>(allocator_for<chunk>(), std::move(part));
+                if (i < keep) snapshot_chunks[i] = shared;
+                else snapshot_chunks.push_back(shared);
+            }
+            parts.push_back(std::move(shared));
+        }
+        snapshot_dirty_from = numeric_limits<size_t>::max();
+        return Snapshot(std::move(parts), data.size());
+    }
+
     // Iterator creators
     
         /**
          * @brief Begin iterator for default order (insertion order).
          * @return Iterator to the beginning.
          */
-        Order begin_order() { return Order(this, 0); }
+        Order begin_order() const { return Order(this, 0); }
     
         /**
          * @brief End iterator for default order (insertion order).
          * @return Iterator past the last element.
          */
-        Order end_order() { return Order(this, data.size()); }
+        Order end_order() const { return Order(this, data.size()); }
 
     
         /**
          * @brief Begin iterator for ascending order.
          * @return Iterator to the smallest element.
          */
-        AscendingOrder begin_ascending_order() { return AscendingOrder(this, 0); }
+        AscendingOrder begin_ascending_order() const { return AscendingOrder(this, 0); }
     
         /**
          * @brief End iterator for ascending order.
          * @return Iterator past the largest element.
          */
-        AscendingOrder end_ascending_order() { return AscendingOrder(this, data.size()); }
+        AscendingOrder end_ascending_order() const { return AscendingOrder(this, data.size()); }
+
+    
+        /**
+         * @brief Begin iterator for ascending order of a projected key.
+         *
+         * Builds a contiguous array of (key, position) pairs, stable-sorts it by key and
+         * keeps only the positions, so the elements themselves are never moved or
+         * compared. Equal keys keep insertion order.
+         * @param proj Callable mapping const T& to the sort key (e.g. a member pointer).
+         * @param comp Ordering of keys. Default is std::less<>.
+         * @return Iterator to the element with the smallest key.
+         */
+        template <typename Proj, typename KeyCompare = std::less<>>
+        ProjectedOrder begin_ascending_order(Proj proj, KeyCompare comp = KeyCompare()) const {
+        using Key = decay_t<invoke_result_t<Proj&, const T&>>;
+        buffer<pair<Key, size_t>> keyed(allocator_for<pair<Key, size_t>>());
+        keyed.reserve(data.size());
+        for (size_t i = 0; i < data.size(); ++i) keyed.emplace_back(std::invoke(proj, data[i]), i);
+        stable_sort_runs(keyed.begin(), keyed.end(),
+                         [&comp](const pair<Key, size_t>& a, const pair<Key, size_t>& b) {
+                             return comp(a.first, b.first);
+                         });
+        index_vector order(keyed.size(), allocator_for<size_t>());
+        for (size_t i = 0; i < keyed.size(); ++i) order[i] = keyed[i].second;
+        auto permutation = allocate_shared<index_vector>(allocator_for<index_vector>(), std::move(order));
+        return ProjectedOrder(this, 0, std::move(permutation));
+    }
+    
+        /**
+         * @brief End iterator for ascending order of a projected key.
+         *
+         * The end position does not depend on the key, so nothing is sorted here. The
+         * result only marks the end: it carries no order, so it cannot be decremented
+         * or indexed into. Use ascending(proj) for a range that can be walked backwards.
+         * @return Iterator past the element with the largest key.
+         */
+        template <typename Proj>
+        ProjectedOrder end_ascending_order(Proj) const {
+        return ProjectedOrder(this, data.size(), nullptr);
+    }
 
     
         /**
          * @brief Begin iterator for descending order.
          * @return Iterator to the largest element.
          */
-        DescendingOrder begin_descending_order() { return DescendingOrder(this, 0); }
+        DescendingOrder begin_descending_order() const { return DescendingOrder(this, 0); }
     
         /**
          * @brief End iterator for descending order.
          * @return Iterator past the smallest element.
          */
-        DescendingOrder end_descending_order() { return DescendingOrder(this, data.size()); }
+        DescendingOrder end_descending_order() const { return DescendingOrder(this, data.size()); }
 
     
         /**
          * @brief Begin iterator for reverse insertion order.
          * @return Iterator to the last inserted element.
          */
-        ReverseOrder begin_reverse_order() { return ReverseOrder(this, 0); }
+        ReverseOrder begin_reverse_order() const { return ReverseOrder(this, 0); }
     
         /**
          * @brief End iterator for reverse insertion order.
          * @return Iterator past the first inserted element.
          */
-        ReverseOrder end_reverse_order() { return ReverseOrder(this, data.size()); }
+        ReverseOrder end_reverse_order() const { return ReverseOrder(this, data.size()); }
 
     
         /**
          * @brief Begin iterator for SideCross order (smallest-largest alternating).
          * @return Iterator to the start of the cross order.
          */
-        SideCrossOrder begin_side_cross_order() { return SideCrossOrder(this, 0); }
+        SideCrossOrder begin_side_cross_order() const { return SideCrossOrder(this, 0); }
     
         /**
          * @brief End iterator for SideCross order.
          * @return Iterator past the last element in the SideCross pattern.
          */
-        SideCrossOrder end_side_cross_order() {
-        return SideCrossOrder(this, (data.size() <= 1 ? data.size() : data.size() / 2));
-    }
+        SideCrossOrder end_side_cross_order() const { return SideCrossOrder(this, data.size()); }
 
     
         /**
          * @brief Begin iterator for MiddleOut order (center to edges).
          * @return Iterator to the middle of the sequence.
          */
-        MiddleOutOrder begin_middle_out_order() { return MiddleOutOrder(this, data.size() / 2); }
+        MiddleOutOrder begin_middle_out_order() const { return MiddleOutOrder(this, 0); }
     
         /**
          * @brief End iterator for MiddleOut order.
          * @return Iterator past the last element.
          */
-        MiddleOutOrder end_middle_out_order() { return MiddleOutOrder(this, data.size()); }
+        MiddleOutOrder end_middle_out_order() const { return MiddleOutOrder(this, data.size()); }
 
-    /**
-     * @brief Basic iterator: iterates in insertion order.
-     */
-    class Order {
-    private:
-        MyContainer* container;
-        size_t index;
+    // Views: each one computes its order once and is used as a range.
 
-    public:
-        Order(MyContainer* cont, size_t idx) : container(cont), index(idx) {
-            if (!cont) throw std::invalid_argument("Container pointer cannot be null");
-        }
+        /**
+         * @brief Insertion order as a range.
+         */
+        OrderView<Order> order() const { return {begin_order(), end_order()}; }
 
-        
         /**
-         * @brief Dereference operator.
-         * @return Reference to the current element.
-         * @throws std::out_of_range if the iterator is out of bounds.
+         * @brief Ascending order as a range.
          */
-        T& operator*() {
-            if (index >= container->data.size())
-                throw std::out_of_range("Iterator is at end position - cannot dereference");
-            return container->data[index];
-        }
+        OrderView<AscendingOrder> ascending() const { return {begin_ascending_order(), end_ascending_order()}; }
 
-        
         /**
-         * @brief Pre-increment operator.
-         * @return Reference to this iterator after advancing.
-         * @throws std::out_of_range if incrementing past end.
+         * @brief Ascending order of a projected key as a range; sorts once, for this view.
+         *
+         * Both ends share one permutation, so the view can be walked backwards.
+         * @param proj Callable mapping const T& to the sort key.
+         * @param comp Ordering of keys. Default is std::less<>.
          */
-        Order& operator++() {
-            if (index >= container->data.size())
-                throw std::out_of_range("Cannot increment iterator past end");
-            ++index;
-            return *this;
-        }
+        template <typename Proj, typename KeyCompare = std::less<>>
+        OrderView<ProjectedOrder> ascending(Proj proj, KeyCompare comp = KeyCompare()) const {
+        ProjectedOrder first = begin_ascending_order(std::move(proj), std::move(comp));
+        ProjectedOrder last = first + static_cast<ptrdiff_t>(data.size());  // shares the permutation
+        return {std::move(first), std::move(last)};
+    }
 
-        
         /**
-         * @brief Post-increment operator.
-         * @return Copy of iterator before incrementing.
+         * @brief Descending order as a range.
          */
-        Order operator++(int) {
-            Order temp = *this;
-            ++(*this);
-            return temp;
-        }
+        OrderView<DescendingOrder> descending() const { return {begin_descending_order(), end_descending_order()}; }
 
-        
         /**
-         * @brief Equality comparison.
-         * @param other Another Order iterator.
-         * @return True if both point to the same container and index.
+         * @brief Reverse insertion order as a range.
          */
-        bool operator==(const Order& other) const {
-            return container == other.container && index == other.index;
-        }
+        OrderView<ReverseOrder> reverse() const { return {begin_reverse_order(), end_reverse_order()}; }
 
-        
         /**
-         * @brief Inequality comparison.
-         * @param other Another Order iterator.
-         * @return True if not equal.
+         * @brief SideCross order as a range.
          */
-        bool operator!=(const Order& other) const {
-            return !(*this == other);
-        }
+        OrderView<SideCrossOrder> side_cross() const { return {begin_side_cross_order(), end_side_cross_order()}; }
 
-        
         /**
-         * @brief Assignment operator.
-         * @param other Iterator to copy from.
-         * @return Reference to this.
+         * @brief MiddleOut order as a range.
          */
-        Order& operator=(const Order& other) {
-            if (this != &other) {
-                container = other.container;
-                index = other.index;
-            }
-            return *this;
-        }
+        OrderView<MiddleOutOrder> middle_out() const { return {begin_middle_out_order(), end_middle_out_order()}; }
+
+        /**
+         * @brief The k smallest elements in ascending order, without sorting the rest.
+         *
+         * Costs O(n + k log k) instead of a full O(n log n) sort, or O(k) if the
+         * ascending index is already cached. Unlike ascending() | views::take(k), it
+         * never builds the full index. Equal elements follow the same rules as ascending().
+         * @param k How many elements to return; clamped to size().
+         * @return A view of the min(k, size()) smallest elements.
+         */
+        OrderView<ProjectedOrder> smallest(size_t k) const {
+        auto permutation = allocate_shared<index_vector>(allocator_for<index_vector>(), first_k_positions(k, false));
+        size_t count = permutation->size();
+        return {ProjectedOrder(this, 0, permutation), ProjectedOrder(this, count, permutation)};
+    }
+
+        /**
+         * @brief The k largest elements in descending order, without sorting the rest.
+         *
+         * Costs O(n + k log k), or O(k) from a cached index, like smallest(). Equal
+         * elements follow the same rules as descending().
+         * @param k How many elements to return; clamped to size().
+         * @return A view of the min(k, size()) largest elements.
+         */
+        OrderView<ProjectedOrder> largest(size_t k) const {
+        auto permutation = allocate_shared<index_vector>(allocator_for<index_vector>(), first_k_positions(k, true));
+        size_t count = permutation->size();
+        return {ProjectedOrder(this, 0, permutation), ProjectedOrder(this, count, permutation)};
+    }
+
+        /**
+         * @brief Ascending order as a lazy range: heapify now, sort only what is read.
+         *
+         * Creating the view heapifies the positions in O(n); reading element k pops the
+         * heap up to k, so a short scan of k elements costs O(n + k log n). Once the
+         * reader passes 1/sort_fraction of the elements, the rest is sorted in one go,
+         * so a full scan stays O(n log n). If the ascending index is already cached it
+         * is used directly. Copies of the view share one traversal state, so use it
+         * from one thread at a time.
+         * @param sort_fraction Larger values switch to the full sort sooner; 1 never
+         * switches (every element is popped) and 0 sorts on the first read. Default is 32.
+         * @return A view over all elements in ascending order.
+         */
+        OrderView<LazySortedOrder> lazy_ascending(size_t sort_fraction = lazy_sort_fraction) const {
+        auto state = allocate_shared<LazyState>(allocator_for<LazyState>(), this, false, sort_fraction);
+        return {LazySortedOrder(this, 0, state), LazySortedOrder(this, data.size(), state)};
+    }
+
+        /**
+         * @brief Descending order as a lazy range; see lazy_ascending().
+         * @param sort_fraction When to sort the rest, as for lazy_ascending(). Default is 32.
+         * @return A view over all elements in descending order.
+         */
+        OrderView<LazySortedOrder> lazy_descending(size_t sort_fraction = lazy_sort_fraction) const {
+        auto state = allocate_shared<LazyState>(allocator_for<LazyState>(), this, true, sort_fraction);
+        return {LazySortedOrder(this, 0, state), LazySortedOrder(this, data.size(), state)};
+    }
+
+    // Const iterator creators. Every order iterator is already a constant iterator
+    // (it yields const T&), so these return the same types as the begin_/end_ calls;
+    // they exist to request read-only traversal explicitly, e.g. on a non-const object.
+
+        Order cbegin_order() const { return begin_order(); }
+        Order cend_order() const { return end_order(); }
+        AscendingOrder cbegin_ascending_order() const { return begin_ascending_order(); }
+        AscendingOrder cend_ascending_order() const { return end_ascending_order(); }
+        DescendingOrder cbegin_descending_order() const { return begin_descending_order(); }
+        DescendingOrder cend_descending_order() const { return end_descending_order(); }
+        ReverseOrder cbegin_reverse_order() const { return begin_reverse_order(); }
+        ReverseOrder cend_reverse_order() const { return end_reverse_order(); }
+        SideCrossOrder cbegin_side_cross_order() const { return begin_side_cross_order(); }
+        SideCrossOrder cend_side_cross_order() const { return end_side_cross_order(); }
+        MiddleOutOrder cbegin_middle_out_order() const { return begin_middle_out_order(); }
+        MiddleOutOrder cend_middle_out_order() const { return end_middle_out_order(); }
+
+    /**
+     * @brief The container epoch an iterator was created at; empty unless checked.
+     */
+    template <bool Checked, typename = void>
+    struct EpochStamp {
+        size_t recorded_epoch = 0;
     };
+    template <typename Unused>
+    struct EpochStamp<false, Unused> {};
 
     /**
-     * @brief Ascending iterator: elements sorted in increasing order.
+     * @brief Shared random-access machinery for all six iteration orders.
+     *
+     * Every order iterator is a container pointer plus a position in its traversal.
+     * Derived only supplies source(pos), which maps a position to an index into data
+     * in O(1); stepping, jumping, distance and comparison all work on the position.
+     *
+     * @tparam Derived The concrete order iterator (CRTP).
      */
-    class AscendingOrder {
-    private:
-        vector<T> sorted;
+    template <typename Derived>
+    class OrderIterator : private EpochStamp<checked_iterators> {
+    protected:
+        const MyContainer* container;
         size_t index;
 
+        /**
+         * @brief Throw if the container was modified after this iterator was created.
+         *
+         * Compiled in only with checked iterators; release builds neither store nor
+         * compare an epoch.
+         * @throws std::logic_error if the iterator has been invalidated.
+         */
+        void check_epoch() const {
+            if constexpr (checked_iterators) {
+                if (this->recorded_epoch != container->modification_epoch)
+                    throw std::logic_error("Iterator invalidated: the container was modified");
+            }
+        }
+
+        /**
+         * @brief Length of the traversal; every order but a top-k one visits all elements.
+         */
+        size_t extent() const { return container->data.size(); }
+
+        /**
+         * @brief The cached ascending index, re-validated in checked builds.
+         */
+        const index_vector& sorted() const {
+            return checked_iterators ? container->ascending_index() : container->sorted_index;
+        }
+
+        /**
+         * @brief The cached stable descending index, re-validated in checked builds.
+         */
+        const index_vector& descending() const {
+            return checked_iterators ? container->descending_view() : container->descending_index;
+        }
+
     public:
-        AscendingOrder(MyContainer* cont, size_t idx) : index(idx) {
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        OrderIterator() : container(nullptr), index(0) {}
+
+        OrderIterator(const MyContainer* cont, size_t idx) : container(cont), index(idx) {
             if (!cont) throw std::invalid_argument("Container pointer cannot be null");
-            sorted = cont->data;
-            sort(sorted.begin(), sorted.end());
+            if constexpr (checked_iterators) this->recorded_epoch = cont->modification_epoch;
         }
 
         
         /**
          * @brief Dereference operator.
          * @return Reference to the current element.
-         * @throws std::out_of_range if the iterator is out of bounds.
+         * @throws std::out_of_range if the iterator is out of bounds (checked builds only).
+         */
+        reference operator*() const {
+            return (*this)[0];
+        }
+
+        
+        /**
+         * @brief Member access through the iterator.
+         */
+        pointer operator->() const {
+            return &**this;
+        }
+
+        
+        /**
+         * @brief Subscript operator: the element k steps away, in O(1).
+         * @param k Offset from the current position (may be negative).
+         * @return Reference to that element.
+         * @throws std::out_of_range if the target is out of bounds (checked builds only).
+         * @throws std::logic_error if the container was modified since (checked builds only).
          */
-        T& operator*() {
-            if (index >= sorted.size())
-                throw std::out_of_range("Iterator is at end position - cannot dereference");
-            return sorted[index];
+        reference operator[](difference_type k) const {
+            size_t pos = index + static_cast<size_t>(k);
+            if constexpr (checked_iterators) {
+                check_epoch();
+                if (pos >= self().extent())
+                    throw std::out_of_range("Iterator is at end position - cannot dereference");
+            }
+            return container->data[self().source(pos)];
         }
 
         
         /**
          * @brief Pre-increment operator.
          * @return Reference to this iterator after advancing.
-         * @throws std::out_of_range if incrementing past end.
+         * @throws std::out_of_range if incrementing past end (checked builds only).
          */
-        AscendingOrder& operator++() {
-            if (index >= sorted.size())
-                throw std::out_of_range("Cannot increment iterator past end");
+        Derived& operator++() {
+            if constexpr (checked_iterators) {
+                check_epoch();
+                if (index >= self().extent())
+                    throw std::out_of_range("Cannot increment iterator past end");
+            }
             ++index;
-            return *this;
+            return self();
         }
 
         
@@ -313,379 +1488,491 @@ public:
          * @brief Post-increment operator.
          * @return Copy of iterator before incrementing.
          */
-        AscendingOrder operator++(int) {
-            AscendingOrder temp = *this;
+        Derived operator++(int) {
+            Derived temp = self();
             ++(*this);
             return temp;
         }
 
         
         /**
-         * @brief Equality check for AscendingOrder.
+         * @brief Pre-decrement operator.
+         * @return Reference to this iterator after stepping back.
+         * @throws std::out_of_range if decrementing before begin (checked builds only).
          */
-        bool operator==(const AscendingOrder& other) const {
-            return sorted == other.sorted && index == other.index;
+        Derived& operator--() {
+            if constexpr (checked_iterators) {
+                check_epoch();
+                if (index == 0)
+                    throw std::out_of_range("Cannot decrement iterator before begin");
+            }
+            --index;
+            return self();
         }
 
         
         /**
-         * @brief Inequality check for AscendingOrder.
+         * @brief Post-decrement operator.
+         * @return Copy of iterator before decrementing.
          */
-        bool operator!=(const AscendingOrder& other) const {
-            return !(*this == other);
+        Derived operator--(int) {
+            Derived temp = self();
+            --(*this);
+            return temp;
         }
 
         
         /**
-         * @brief Assignment operator for AscendingOrder.
+         * @brief Move by k positions in O(1).
+         * @throws std::out_of_range if leaving [begin, end] (checked builds only).
          */
-        AscendingOrder& operator=(const AscendingOrder& other) {
-            if (this != &other) {
-                sorted = other.sorted;
-                index = other.index;
+        Derived& operator+=(difference_type k) {
+            if constexpr (checked_iterators) {
+                check_epoch();
+                difference_type target = static_cast<difference_type>(index) + k;
+                if (target < 0 || static_cast<size_t>(target) > self().extent())
+                    throw std::out_of_range("Cannot move iterator outside its range");
             }
-            return *this;
-        }
-    };
-
-    /**
-     * @brief Descending iterator: elements sorted in decreasing order.
-     */
-    class DescendingOrder {
-    private:
-        vector<T> sorted;
-        size_t index;
-
-    public:
-        DescendingOrder(MyContainer* cont, size_t idx) : index(idx) {
-            if (!cont) throw std::invalid_argument("Container pointer cannot be null");
-            sorted = cont->data;
-            sort(sorted.begin(), sorted.end());
-            reverse(sorted.begin(), sorted.end());
+            index += static_cast<size_t>(k);
+            return self();
         }
 
         
         /**
-         * @brief Dereference operator.
-         * @return Reference to the current element.
-         * @throws std::out_of_range if the iterator is out of bounds.
+         * @brief Move back by k positions in O(1).
          */
-        T& operator*() {
-            if (index >= sorted.size())
-                throw std::out_of_range("Iterator is at end position - cannot dereference");
-            return sorted[index];
+        Derived& operator-=(difference_type k) {
+            return *this += -k;
         }
 
         
         /**
-         * @brief Pre-increment operator.
-         * @return Reference to this iterator after advancing.
-         * @throws std::out_of_range if incrementing past end.
+         * @brief Iterator k positions away from this one.
          */
-        DescendingOrder& operator++()  {
-            if (index >= sorted.size())
-                throw std::out_of_range("Cannot increment iterator past end");
-            ++index;
-            return *this;
+        Derived operator+(difference_type k) const {
+            Derived temp = self();
+            temp += k;
+            return temp;
+        }
+
+        friend Derived operator+(difference_type k, const Derived& it) {
+            return it + k;
         }
 
         
         /**
-         * @brief Post-increment operator.
-         * @return Copy of iterator before incrementing.
+         * @brief Iterator k positions before this one.
          */
-        DescendingOrder operator++(int) {
-            DescendingOrder temp = *this;
-            ++(*this);
+        Derived operator-(difference_type k) const {
+            Derived temp = self();
+            temp -= k;
             return temp;
         }
 
-                /**
-         * @brief Equality operator for DescendingOrder.
+        
+        /**
+         * @brief Number of steps from other to this iterator.
          */
-        bool operator==(const DescendingOrder& other) const {
-            return sorted == other.sorted && index == other.index;
+        friend difference_type operator-(const Derived& a, const Derived& b) {
+            return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
         }
 
-                /**
-         * @brief Inequality operator for DescendingOrder.
+        
+        /**
+         * @brief Equality: same container and same position.
          */
-        bool operator!=(const DescendingOrder& other) const {
-            return !(*this == other);
+        friend bool operator==(const Derived& a, const Derived& b) {
+            return a.container == b.container && a.index == b.index;
         }
 
-                /**
-         * @brief Assignment operator for DescendingOrder.
+        
+        /**
+         * @brief Inequality comparison.
          */
-        DescendingOrder& operator=(const DescendingOrder& other) {
-            if (this != &other) {
-                sorted = other.sorted;
-                index = other.index;
-            }
-            return *this;
+        friend bool operator!=(const Derived& a, const Derived& b) {
+            return !(a == b);
         }
+
+        
+        /**
+         * @brief Ordering by position within the same traversal.
+         */
+        friend bool operator<(const Derived& a, const Derived& b) { return a.index < b.index; }
+        friend bool operator>(const Derived& a, const Derived& b) { return b < a; }
+        friend bool operator<=(const Derived& a, const Derived& b) { return !(b < a); }
+        friend bool operator>=(const Derived& a, const Derived& b) { return !(a < b); }
+
+    private:
+        const Derived& self() const { return static_cast<const Derived&>(*this); }
+        Derived& self() { return static_cast<Derived&>(*this); }
     };
 
     /**
-     * @brief Reverse iterator: elements in reverse insertion order.
+     * @brief Basic iterator: iterates in insertion order.
      */
-    class ReverseOrder {
-    private:
-        vector<T> reversed;
-        size_t index;
-
+    class Order : public OrderIterator<Order> {
     public:
-        ReverseOrder(MyContainer* cont, size_t idx) : index(idx) {
-            if (!cont) throw std::invalid_argument("Container pointer cannot be null");
-            reversed = cont->data;
-            reverse(reversed.begin(), reversed.end());
-        }
+        using OrderIterator<Order>::OrderIterator;
 
-        
         /**
-         * @brief Dereference operator.
-         * @return Reference to the current element.
-         * @throws std::out_of_range if the iterator is out of bounds.
+         * @brief Position pos is data[pos].
          */
-        T& operator*() {
-            if (index >= reversed.size())
-                throw std::out_of_range("Iterator is at end position - cannot dereference");
-            return reversed[index];
+        size_t source(size_t pos) const { return pos; }
+    };
+
+    /**
+     * @brief Ascending iterator: elements sorted in increasing order.
+     *
+     * Reads through the container's cached sorted index, so creating or copying
+     * the iterator never copies or re-sorts the data.
+     */
+    class AscendingOrder : public OrderIterator<AscendingOrder> {
+    public:
+        AscendingOrder() = default;
+        AscendingOrder(const MyContainer* cont, size_t idx) : OrderIterator<AscendingOrder>(cont, idx) {
+            cont->ascending_index();
         }
 
-        
         /**
-         * @brief Pre-increment operator.
-         * @return Reference to this iterator after advancing.
-         * @throws std::out_of_range if incrementing past end.
+         * @brief Position pos is the element of rank pos.
          */
-        ReverseOrder& operator++() {
-            if (index >= reversed.size())
-                throw std::out_of_range("Cannot increment iterator past end");
-            ++index;
-            return *this;
+        size_t source(size_t pos) const { return this->sorted()[pos]; }
+    };
+
+    /**
+     * @brief Descending iterator: elements sorted in decreasing order.
+     *
+     * Walks the container's cached ascending index from the back; in stable mode it
+     * reads the derived stable descending index instead.
+     */
+    class DescendingOrder : public OrderIterator<DescendingOrder> {
+    public:
+        DescendingOrder() = default;
+        DescendingOrder(const MyContainer* cont, size_t idx) : OrderIterator<DescendingOrder>(cont, idx) {
+            if (cont->stable_ordering) cont->descending_view();
+            else cont->ascending_index();
         }
 
-        
         /**
-         * @brief Post-increment operator.
-         * @return Copy of iterator before incrementing.
+         * @brief Position pos is the element of rank size - 1 - pos.
          */
-        ReverseOrder operator++(int) {
-            ReverseOrder temp = *this;
-            ++(*this);
-            return temp;
+        size_t source(size_t pos) const {
+            if (this->container->stable_ordering) return this->descending()[pos];
+            const index_vector& sorted = this->sorted();
+            return sorted[sorted.size() - 1 - pos];
         }
+    };
+
+    /**
+     * @brief Reverse iterator: elements in reverse insertion order.
+     *
+     * Position k reads data[size - 1 - k] directly; nothing is copied.
+     */
+    class ReverseOrder : public OrderIterator<ReverseOrder> {
+    public:
+        using OrderIterator<ReverseOrder>::OrderIterator;
 
-                /**
-         * @brief Equality operator for ReverseOrder.
+        /**
+         * @brief Position pos is data[size - 1 - pos].
          */
-        bool operator==(const ReverseOrder& other) const {
-            return reversed == other.reversed && index == other.index;
+        size_t source(size_t pos) const { return this->container->data.size() - 1 - pos; }
+    };
+
+    /**
+     * @brief SideCross iterator: alternates between smallest and largest remaining elements.
+     *
+     * Position k maps straight to a rank in the cached sorted index (k/2 from the
+     * front for even k, k/2 from the back for odd k). In stable mode the back half is
+     * read through the stable descending index, so ties come in insertion order there too.
+     */
+    class SideCrossOrder : public OrderIterator<SideCrossOrder> {
+    public:
+        SideCrossOrder() = default;
+        SideCrossOrder(const MyContainer* cont, size_t idx) : OrderIterator<SideCrossOrder>(cont, idx) {
+            if (cont->stable_ordering) cont->descending_view();
+            else cont->ascending_index();
         }
 
-                /**
-         * @brief Inequality operator for ReverseOrder.
+        /**
+         * @brief Map a traversal position to a position in data.
+         *
+         * O(1), except in stable mode for the one run of equal elements that spans the
+         * middle rank: the front takes its first elements, so the back takes the rest,
+         * found with a binary search for the end of the run.
+         * @param pos Position within the side-cross sequence (pos < size).
+         * @return Index into data of the element visited at pos.
          */
-        bool operator!=(const ReverseOrder& other) const {
-            return !(*this == other);
+        size_t source(size_t pos) const {
+            const index_vector& sorted = this->sorted();
+            if (pos % 2 == 0) return sorted[pos / 2];
+            size_t n = sorted.size(), rank = n - 1 - pos / 2;
+            const MyContainer& c = *this->container;
+            if (!c.stable_ordering) return sorted[rank];
+
+            size_t half = (n + 1) / 2;  // ranks below half are taken from the front
+            if (c.value_less(c.data[sorted[half - 1]], c.data[sorted[rank]])) return this->descending()[pos / 2];
+            auto run_end = upper_bound(sorted.begin() + rank, sorted.end(), sorted[rank], c.position_less());
+            return sorted[half + static_cast<size_t>(run_end - sorted.begin()) - 1 - rank];
         }
+    };
+
+    /**
+     * @brief MiddleOut iterator: starts at middle, moves outward alternately left and right.
+     *
+     * Position 0 is data[size / 2]; odd positions step left and even positions step
+     * right of it.
+     */
+    class MiddleOutOrder : public OrderIterator<MiddleOutOrder> {
+    public:
+        using OrderIterator<MiddleOutOrder>::OrderIterator;
 
-                /**
-         * @brief Assignment operator for ReverseOrder.
+        /**
+         * @brief Map a traversal position to a position in data.
+         * @param pos Position within the middle-out sequence (pos < size).
+         * @return Index into data of the element visited at pos.
          */
-        ReverseOrder& operator=(const ReverseOrder& other) {
-            if (this != &other) {
-                reversed = other.reversed;
-                index = other.index;
-            }
-            return *this;
+        size_t source(size_t pos) const {
+            size_t middle = this->container->data.size() / 2;
+            return (pos % 2 == 1) ? middle - (pos + 1) / 2 : middle + pos / 2;
         }
     };
 
     /**
-     * @brief SideCross iterator: alternates between smallest and largest remaining elements.
+     * @brief Iterator over a permutation computed for one traversal (a projected sort or a top-k).
+     *
+     * The permutation is shared between copies of the iterator, so copies stay O(1).
+     * It is a snapshot: it does not follow later add/remove calls.
      */
-    class SideCrossOrder {
+    class ProjectedOrder : public OrderIterator<ProjectedOrder> {
     private:
-        vector<T> sorted;
-        size_t left, right, index;
-        bool left_turn;
+        shared_ptr<const index_vector> permutation;
 
     public:
-        SideCrossOrder(MyContainer* cont, size_t idx) : index(idx) {
-            if (!cont) throw std::invalid_argument("Container pointer cannot be null");
-            sorted = cont->data;
-            sort(sorted.begin(), sorted.end());
-            left_turn = true;
-            left = 0;
-            right = sorted.size() > 0 ? sorted.size() - 1 : 0;
-        }
+        ProjectedOrder() = default;
+        ProjectedOrder(const MyContainer* cont, size_t idx, shared_ptr<const index_vector> perm)
+            : OrderIterator<ProjectedOrder>(cont, idx), permutation(std::move(perm)) {}
 
-        
         /**
-         * @brief Dereference operator.
-         * @return Reference to the current element.
-         * @throws std::out_of_range if the iterator is out of bounds.
+         * @brief Position pos is the pos-th entry of the permutation.
+         * @throws std::logic_error for an iterator without a permutation, i.e. one from
+         * end_ascending_order(proj) moved off the end (checked builds only).
          */
-        T& operator*() {
-            if (sorted.empty() || index >= sorted.size() || left > right)
-                throw std::out_of_range("Iterator out of range");
-            index = left_turn ? left : right;
-            return sorted[index];
-        }
-
-        
-        /**
-         * @brief Pre-increment operator.
-         * @return Reference to this iterator after advancing.
-         * @throws std::out_of_range if incrementing past end.
-         */
-       SideCrossOrder& operator++() {
-            if (index >= sorted.size() || left > right)
-                throw std::out_of_range("Cannot increment iterator past end");
-            if (sorted.size() == 1) {
-                ++index;
-            } else if (left_turn) {
-                index = left++;
-                left_turn = false;
-            } else {
-                index = right--;
-                left_turn = true;
+        size_t source(size_t pos) const {
+            if constexpr (checked_iterators) {
+                if (!permutation) throw std::logic_error("end_ascending_order(proj) iterator has no order to step into");
             }
-            return *this;
+            return (*permutation)[pos];
         }
 
-        
         /**
-         * @brief Post-increment operator.
-         * @return Copy of iterator before incrementing.
+         * @brief Length of the permutation, which is shorter than the container for top-k.
          */
-       SideCrossOrder operator++(int) {
-            SideCrossOrder temp = *this;
-            ++(*this);
-            return temp;
+        size_t extent() const { return permutation ? permutation->size() : this->container->data.size(); }
+    };
+
+    /**
+     * @brief Shared state of one lazy sorted traversal.
+     *
+     * A single array holds a heap of the positions not produced yet at the front and
+     * the produced positions, in traversal order, stacked from the back: element k of
+     * the traversal is slots[n - 1 - k]. Popping the heap moves its top to exactly that
+     * slot, so producing needs no second buffer.
+     */
+    struct LazyState {
+        const MyContainer* owner;
+        bool descending;
+        index_vector slots;
+        size_t produced = 0;
+        size_t sort_from;  ///< First traversal position that triggers the full sort.
+
+        LazyState(const MyContainer* cont, bool desc, size_t sort_fraction)
+            : owner(cont), descending(desc), slots(cont->allocator_for<size_t>()) {
+            size_t n = cont->data.size();
+            sort_from = sort_fraction == 0 ? 0 : n / sort_fraction;
+            if (cont->sorted_valid.load(memory_order_acquire) && !(desc && cont->stable_ordering)) {
+                const index_vector& asc = cont->sorted_index;
+                if (desc) slots.assign(asc.begin(), asc.end());
+                else slots.assign(asc.rbegin(), asc.rend());
+                produced = n;
+                return;
+            }
+            slots.resize(n);
+            iota(slots.begin(), slots.end(), size_t(0));
+            make_heap(slots.begin(), slots.end(), heap_order());
         }
 
-                /**
-         * @brief Equality operator for SideCrossOrder.
+        /**
+         * @brief Heap comparator: the top of the heap is the next element of the traversal.
          */
-        bool operator==(const SideCrossOrder& other) const {
-            return sorted == other.sorted && index == other.index;
+        auto heap_order() const {
+            auto before = owner->traversal_before(descending);
+            return [before](size_t a, size_t b) { return before(b, a); };
         }
 
-                /**
-         * @brief Inequality operator for SideCrossOrder.
+        /**
+         * @brief Make sure traversal position pos has been produced.
          */
-        bool operator!=(const SideCrossOrder& other) const {
-            return !(*this == other);
+        void produce_through(size_t pos) {
+            if (pos < produced) return;
+            size_t n = slots.size();
+            if (pos >= sort_from) {
+                finish();
+                return;
+            }
+            auto order = heap_order();
+            while (produced <= pos) {
+                pop_heap(slots.begin(), slots.begin() + (n - produced), order);
+                ++produced;
+            }
         }
 
-                /**
-         * @brief Assignment operator for SideCrossOrder.
+        /**
+         * @brief Sort everything still in the heap, leaving it in back-to-front order.
          */
-        SideCrossOrder& operator=(const SideCrossOrder& other) {
-            if (this != &other) {
-                sorted = other.sorted;
-                index = other.index;
-                left = other.left;
-                right = other.right;
-                left_turn = other.left_turn;
+        void finish() {
+            auto rest_end = slots.begin() + (slots.size() - produced);
+            if (owner->stable_ordering) {
+                sort(slots.begin(), rest_end, heap_order());
+            } else {
+                owner->sort_positions(slots.begin(), rest_end);
+                if (!descending) std::reverse(slots.begin(), rest_end);
             }
-            return *this;
+            produced = slots.size();
         }
     };
 
     /**
-     * @brief MiddleOut iterator: starts at middle, moves outward alternately left and right.
+     * @brief Iterator over a lazy sorted traversal; produces elements as they are read.
      */
-    class MiddleOutOrder {
+    class LazySortedOrder : public OrderIterator<LazySortedOrder> {
     private:
-        vector<T> sequence;
-        size_t index, offset;
-        bool move_left;
+        shared_ptr<LazyState> state;
 
     public:
-        MiddleOutOrder(MyContainer* cont, size_t idx) : index(idx), offset(0), move_left(true) {
-            if (!cont) throw std::invalid_argument("Container pointer cannot be null");
-            sequence = cont->data;
-        }
+        LazySortedOrder() = default;
+        LazySortedOrder(const MyContainer* cont, size_t idx, shared_ptr<LazyState> st)
+            : OrderIterator<LazySortedOrder>(cont, idx), state(std::move(st)) {}
 
-        
         /**
-         * @brief Dereference operator.
-         * @return Reference to the current element.
-         * @throws std::out_of_range if the iterator is out of bounds.
+         * @brief Position pos of the traversal, producing it first if needed.
          */
-        T& operator*() {
-            if (index >= sequence.size())
-                throw std::out_of_range("Iterator is at end position - cannot dereference");
-            return sequence[index];
+        size_t source(size_t pos) const {
+            state->produce_through(pos);
+            return state->slots[state->slots.size() - 1 - pos];
         }
+    };
 
-        
+    /**
+     * @brief Immutable point-in-time copy of a container, returned by snapshot().
+     *
+     * Holds shared pointers to chunks of snapshot_chunk elements; copying a snapshot
+     * copies only those pointers. Iteration is in insertion order. The chunks come
+     * from the container's allocator, so a snapshot must not outlive its memory
+     * resource.
+     */
+    class Snapshot {
+    private:
+        buffer<shared_ptr<const chunk>> chunks;
+        size_t count = 0;
+
+        Snapshot(buffer<shared_ptr<const chunk>> parts, size_t n) : chunks(std::move(parts)), count(n) {}
+        friend class MyContainer;
+
+    public:
         /**
-         * @brief Pre-increment operator.
-         * @return Reference to this iterator after advancing.
-         * @throws std::out_of_range if incrementing past end.
-         */
-        MiddleOutOrder&  operator++() {
-            if (move_left) {
-                if (index > offset) {
-                    index -= ++offset;
-                    move_left = false;
-                } else {
-                    index = sequence.size();
-                }
-            } else {
-                if (index + offset < sequence.size()) {
-                    index += ++offset;
-                    move_left = true;
-                } else {
-                    index = sequence.size();
-                }
+         * @brief Random-access iterator over a snapshot, in insertion order.
+         */
+        class Iterator {
+        private:
+            const Snapshot* owner = nullptr;
+            size_t index = 0;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            Iterator() = default;
+            Iterator(const Snapshot* snap, size_t idx) : owner(snap), index(idx) {}
+
+            reference operator*() const { return (*owner)[index]; }
+            pointer operator->() const { return &(*owner)[index]; }
+            reference operator[](difference_type k) const { return (*owner)[index + static_cast<size_t>(k)]; }
+
+            Iterator& operator++() { ++index; return *this; }
+            Iterator operator++(int) { Iterator temp = *this; ++index; return temp; }
+            Iterator& operator--() { --index; return *this; }
+            Iterator operator--(int) { Iterator temp = *this; --index; return temp; }
+            Iterator& operator+=(difference_type k) { index += static_cast<size_t>(k); return *this; }
+            Iterator& operator-=(difference_type k) { index -= static_cast<size_t>(k); return *this; }
+            Iterator operator+(difference_type k) const { Iterator temp = *this; return temp += k; }
+            Iterator operator-(difference_type k) const { Iterator temp = *this; return temp -= k; }
+            friend Iterator operator+(difference_type k, const Iterator& it) { return it + k; }
+            friend difference_type operator-(const Iterator& a, const Iterator& b) {
+                return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
             }
-            return *this;
-        }
 
-        
+            friend bool operator==(const Iterator& a, const Iterator& b) { return a.owner == b.owner && a.index == b.index; }
+            friend bool operator!=(const Iterator& a, const Iterator& b) { return !(a == b); }
+            friend bool operator<(const Iterator& a, const Iterator& b) { return a.index < b.index; }
+            friend bool operator>(const Iterator& a, const Iterator& b) { return b < a; }
+            friend bool operator<=(const Iterator& a, const Iterator& b) { return !(b < a); }
+            friend bool operator>=(const Iterator& a, const Iterator& b) { return !(a < b); }
+        };
+
+        Snapshot() = default;
+
         /**
-         * @brief Post-increment operator.
-         * @return Copy of iterator before incrementing.
+         * @brief Get the number of elements captured.
          */
-        MiddleOutOrder operator++(int) {
-            MiddleOutOrder temp = *this;
-            ++(*this);
-            return temp;
-        }
+        size_t size() const { return count; }
 
-                /**
-         * @brief Equality operator for MiddleOutOrder.
+        /**
+         * @brief Element at insertion position pos.
+         * @throws std::out_of_range if pos >= size() (checked builds only).
          */
-        bool operator==(const MiddleOutOrder& other) const {
-            return sequence == other.sequence && index == other.index;
+        const T& operator[](size_t pos) const {
+            if constexpr (checked_iterators) {
+                if (pos >= count) throw std::out_of_range("Snapshot position out of range");
+            }
+            return (*chunks[pos >> snapshot_chunk_bits])[pos & (snapshot_chunk - 1)];
         }
 
-                /**
-         * @brief Inequality operator for MiddleOutOrder.
-         */
-        bool operator!=(const MiddleOutOrder& other) const {
-            return !(*this == other);
-        }
+        Iterator begin_order() const { return Iterator(this, 0); }
+        Iterator end_order() const { return Iterator(this, count); }
 
-                /**
-         * @brief Assignment operator for MiddleOutOrder.
+        /**
+         * @brief Print the snapshot using stream output, like the container itself.
          */
-        MiddleOutOrder& operator=(const MiddleOutOrder& other) {
-            if (this != &other) {
-                sequence = other.sequence;
-                index = other.index;
-                offset = other.offset;
-                move_left = other.move_left;
+        friend ostream& operator<<(ostream& os, const Snapshot& snap) {
+            os << "{";
+            for (size_t i = 0; i < snap.count; ++i) {
+                os << snap[i];
+                if (i < snap.count - 1) os << ", ";
             }
-            return *this;
+            os << "}";
+            return os;
         }
     };
 };
 
+/**
+ * @brief MyContainer whose elements and internal buffers come from a std::pmr::memory_resource.
+ *
+ * Not a nested ariel::pmr namespace: this header imports std, so a second pmr would make
+ * every unqualified pmr:: ambiguous in code that also uses namespace ariel.
+ */
+template <typename T = int, typename Compare = std::less<T>>
+using PmrMyContainer = MyContainer<T, Compare, std::pmr::polymorphic_allocator<T>>;
+
 }  // namespace ariel
+
+#ifdef __cpp_lib_ranges
+/// OrderView is a cheap-to-copy view whose iterators point into the container, not the view.
+template <typename Iterator>
+inline constexpr bool std::ranges::enable_view<ariel::OrderView<Iterator>> = true;
+template <typename Iterator>
+inline constexpr bool std::ranges::enable_borrowed_range<ariel::OrderView<Iterator>> = true;
+#endif
@@ -0,0 +1,388 @@
+//adi.gamzu@gmail.com
+
+// Microbenchmarks for MyContainer, reported in Google Benchmark's JSON layout.
+//
+//   ./bench.out [--min_n=1000] [--max_n=10000000] [--min_time=0.2] [--threads=N]
+//
+// Every benchmark is repeated until --min_time seconds have been spent in the
+// timed region; "real_time" is the mean time per item (per add, per remove
+// call, or per element visited in a traversal), in nanoseconds.
+
+#include "MyContainer.hpp"
+#include "ConcurrentMyContainer.hpp"
+#include "AppendBuffer.hpp"
+#include "MappedContainer.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ariel;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    size_t min_n = 1000;
+    size_t max_n = 10000000;
+    double min_time = 0.2;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string filter;  ///< Only benchmarks whose name contains this are run.
+};
+
+struct Result {
+    std::string name;
+    size_t iterations;
+    double ns_per_item;
+    size_t items_per_iteration;
+    std::string label;
+};
+
+std::vector<Result> results;
+volatile size_t sink = 0;
+
+/// Fold a value into the volatile sink (spelled out: compound assignment to volatile is deprecated).
+inline void keep(size_t v) { sink = sink + v; }
+
+/// Keep a value observable so the optimizer cannot drop the loop computing it.
+inline void consume(int v) { keep(static_cast<size_t>(v)); }
+inline void consume(double v) { keep(static_cast<size_t>(v != 0.0)); }
+inline void consume(const std::string& v) { keep(v.size()); }
+
+/**
+ * @brief Repeat a timed body until min_time has elapsed and record the mean.
+ * @param body Runs one iteration and returns the seconds spent in its timed region.
+ * @return False if --filter skipped the benchmark, so results.back() is not its result.
+ */
+bool run(const Options& opt, const std::string& name, size_t items,
+         const std::function<double()>& body) {
+    if (name.find(opt.filter) == std::string::npos) return false;
+    size_t iterations = 0;
+    double seconds = 0;
+    while (seconds < opt.min_time || iterations == 0) {
+        seconds += body();
+        ++iterations;
+    }
+    double ns = seconds * 1e9 / (static_cast<double>(iterations) * static_cast<double>(items));
+    results.push_back({name, iterations, ns, items, ""});
+    return true;
+}
+
+double since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// ----------  input data  ----------
+template <typename T> T make_value(std::mt19937_64& rng, size_t distinct);
+
+template <> int make_value<int>(std::mt19937_64& rng, size_t distinct) {
+    return static_cast<int>(rng() % distinct);
+}
+template <> double make_value<double>(std::mt19937_64& rng, size_t distinct) {
+    return static_cast<double>(rng() % distinct) * 0.5 - 1000.0;
+}
+template <> std::string make_value<std::string>(std::mt19937_64& rng, size_t distinct) {
+    return "key-" + std::to_string(rng() % distinct) + "-padding";
+}
+
+template <typename T>
+std::vector<T> make_input(size_t n, size_t distinct) {
+    std::mt19937_64 rng(42);
+    std::vector<T> values;
+    values.reserve(n);
+    for (size_t i = 0; i < n; ++i) values.push_back(make_value<T>(rng, distinct));
+    return values;
+}
+
+// ----------  benchmarks  ----------
+template <typename Begin, typename End>
+void bench_traversal(const Options& opt, const std::string& name, size_t n, Begin begin, End end) {
+    run(opt, name, n, [&] {
+        auto start = Clock::now();
+        auto stop_at = end();
+        for (auto it = begin(); it != stop_at; ++it) consume(*it);
+        return since(start);
+    });
+}
+
+template <typename T>
+void bench_type(const Options& opt, const std::string& type) {
+    for (size_t n = opt.min_n; n <= opt.max_n; n *= 10) {
+        const std::string suffix = "/" + type + "/" + std::to_string(n);
+        const size_t distinct = n / 10 + 1;
+        const std::vector<T> input = make_input<T>(n, distinct);
+
+        run(opt, "add" + suffix, n, [&] {
+            MyContainer<T> c;
+            auto start = Clock::now();
+            for (const T& v : input) c.add(v);
+            double s = since(start);
+            keep(c.size());
+            return s;
+        });
+
+        MyContainer<T> full;
+        full.add_range(input.begin(), input.end());
+
+        run(opt, "remove" + suffix, 1, [&] {
+            MyContainer<T> c(full);
+            auto start = Clock::now();
+            c.remove(input[n / 2]);
+            double s = since(start);
+            keep(c.size());
+            return s;
+        });
+
+        // One insert followed by one ordered scan: the sorted index is kept up to date.
+        run(opt, "add_then_ascending_scan" + suffix, n, [&] {
+            MyContainer<T> c(full);
+            c.begin_ascending_order();
+            auto start = Clock::now();
+            c.add(input[n / 3]);
+            for (auto it = c.begin_ascending_order(), end = c.end_ascending_order(); it != end; ++it)
+                consume(*it);
+            return since(start);
+        });
+
+        // Building the ascending view from scratch, serial and on --threads threads.
+        auto sort_with = [&](unsigned threads) {
+            return [&, threads] {
+                MyContainer<T> c;
+                c.set_sort_threads(threads);
+                c.add_range(input.begin(), input.end());
+                auto start = Clock::now();
+                c.begin_ascending_order();
+                return since(start);
+            };
+        };
+        double serial = 0;
+        if (run(opt, "sort_ascending/threads:1" + suffix, n, sort_with(1))) serial = results.back().ns_per_item;
+        if (opt.threads > 1 &&
+            run(opt, "sort_ascending/threads:" + std::to_string(opt.threads) + suffix, n, sort_with(opt.threads)) &&
+            serial > 0) {
+            results.back().label = "speedup=" + std::to_string(serial / results.back().ns_per_item);
+        }
+
+        // Reading only the 10 largest elements: selection instead of a full sort.
+        run(opt, "largest_10" + suffix, n, [&] {
+            MyContainer<T> c(full);
+            auto start = Clock::now();
+            for (const T& v : c.largest(10)) consume(v);
+            return since(start);
+        });
+
+        // Lazy heap-based traversal: a short scan, and a full scan that switches to a sort.
+        run(opt, "lazy_descending_first_10" + suffix, n, [&] {
+            MyContainer<T> c(full);
+            auto start = Clock::now();
+            auto view = c.lazy_descending();
+            for (auto it = view.begin(), end = view.begin() + std::min<size_t>(10, n); it != end; ++it) consume(*it);
+            return since(start);
+        });
+        run(opt, "lazy_ascending_full" + suffix, n, [&] {
+            MyContainer<T> c(full);
+            auto start = Clock::now();
+            for (const T& v : c.lazy_ascending()) consume(v);
+            return since(start);
+        });
+
+        bench_traversal(opt, "traverse_order" + suffix, n,
+                        [&] { return full.begin_order(); }, [&] { return full.end_order(); });
+        bench_traversal(opt, "traverse_ascending" + suffix, n,
+                        [&] { return full.begin_ascending_order(); }, [&] { return full.end_ascending_order(); });
+        bench_traversal(opt, "traverse_descending" + suffix, n,
+                        [&] { return full.begin_descending_order(); }, [&] { return full.end_descending_order(); });
+        bench_traversal(opt, "traverse_reverse" + suffix, n,
+                        [&] { return full.begin_reverse_order(); }, [&] { return full.end_reverse_order(); });
+        bench_traversal(opt, "traverse_side_cross" + suffix, n,
+                        [&] { return full.begin_side_cross_order(); }, [&] { return full.end_side_cross_order(); });
+        bench_traversal(opt, "traverse_middle_out" + suffix, n,
+                        [&] { return full.begin_middle_out_order(); }, [&] { return full.end_middle_out_order(); });
+    }
+}
+
+// Aggregate read throughput of ConcurrentMyContainer as reader threads are added.
+void bench_concurrent_readers(const Options& opt) {
+    const size_t n = std::min<size_t>(opt.max_n, 1000000);
+    const std::vector<int> input = make_input<int>(n, n / 10 + 1);
+    ConcurrentMyContainer<int> shared;
+    shared.add_range(input.begin(), input.end());
+    const int scans_per_reader = 4;
+
+    double single = 0;
+    for (unsigned readers = 1; readers <= opt.threads; readers *= 2) {
+        const std::string name = "concurrent_read_ascending/readers:" + std::to_string(readers) +
+                                 "/int/" + std::to_string(n);
+        bool ran = run(opt, name, n * readers * scans_per_reader, [&] {
+            auto start = Clock::now();
+            std::vector<std::thread> pool;
+            for (unsigned r = 0; r < readers; ++r) {
+                pool.emplace_back([&] {
+                    for (int k = 0; k < scans_per_reader; ++k) {
+                        auto view = shared.read();
+                        size_t local = 0;
+                        for (auto it = view.begin_ascending_order(), end = view.end_ascending_order(); it != end; ++it)
+                            local += static_cast<size_t>(*it);
+                        keep(local);
+                    }
+                });
+            }
+            for (std::thread& t : pool) t.join();
+            return since(start);
+        });
+        if (!ran) continue;
+        if (readers == 1) single = results.back().ns_per_item;
+        else if (single > 0) results.back().label = "scaling=" + std::to_string(single / results.back().ns_per_item);
+    }
+}
+
+// Aggregate ingest rate of AppendBuffer producers, plus the publish that follows.
+void bench_append_buffer(const Options& opt) {
+    const size_t per_producer = std::min<size_t>(opt.max_n, 1000000);
+    double single_producer = 0;
+
+    for (unsigned producers = 1; producers <= opt.threads; producers *= 2) {
+        const std::string suffix = "/producers:" + std::to_string(producers) + "/int/" +
+                                   std::to_string(per_producer * producers);
+        AppendBuffer<int> buffer;
+        MyContainer<int> c;
+        bool pushed = run(opt, "append_buffer_push" + suffix, per_producer * producers, [&] {
+            auto start = Clock::now();
+            std::vector<std::thread> pool;
+            for (unsigned p = 0; p < producers; ++p) {
+                pool.emplace_back([&buffer, per_producer, p] {
+                    for (size_t i = 0; i < per_producer; ++i) buffer.push(static_cast<int>(i ^ p));
+                });
+            }
+            for (std::thread& t : pool) t.join();
+            double s = since(start);
+            MyContainer<int>().swap(c);
+            buffer.publish(c);
+            keep(c.size());
+            return s;
+        });
+        if (pushed) {
+            double adds_per_sec = 1e9 / results.back().ns_per_item;
+            if (producers == 1) single_producer = adds_per_sec;
+            results.back().label = "adds_per_sec=" + std::to_string(adds_per_sec);
+            if (producers > 1 && single_producer > 0)
+                results.back().label += ",scaling=" + std::to_string(adds_per_sec / single_producer);
+        }
+
+        run(opt, "append_buffer_publish" + suffix, per_producer * producers, [&] {
+            for (size_t i = 0; i < per_producer * producers; ++i) buffer.push(static_cast<int>(i));
+            MyContainer<int> target;
+            auto start = Clock::now();
+            buffer.publish(target);
+            double s = since(start);
+            keep(target.size());
+            return s;
+        });
+    }
+}
+
+// save()/load() throughput, and opening plus scanning the same file through a mapping.
+void bench_persistence(const Options& opt) {
+    const size_t n = opt.max_n;
+    const std::string path = (std::filesystem::temp_directory_path() / "ariel_bench_persistence.bin").string();
+    const std::string suffix = "/int/" + std::to_string(n);
+    MyContainer<int> c;
+    for (int v : make_input<int>(n, n)) c.add(v);
+
+    run(opt, "save" + suffix, n, [&] {
+        auto start = Clock::now();
+        c.save(path);
+        return since(start);
+    });
+    run(opt, "load" + suffix, n, [&] {
+        MyContainer<int> back;
+        auto start = Clock::now();
+        back.load(path);
+        double s = since(start);
+        keep(back.size());
+        return s;
+    });
+    run(opt, "mapped_open" + suffix, n, [&] {
+        auto start = Clock::now();
+        MappedContainer<int> mapped(path);
+        double s = since(start);
+        keep(mapped.size());
+        return s;
+    });
+    run(opt, "mapped_scan" + suffix, n, [&] {
+        auto start = Clock::now();
+        MappedContainer<int> mapped(path);
+        long long sum = 0;
+        for (int v : mapped) sum += v;
+        double s = since(start);
+        keep(static_cast<size_t>(sum));
+        return s;
+    });
+    std::filesystem::remove(path);
+}
+
+// ----------  output  ----------
+void print_json() {
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    std::cout << "{\n  \"context\": {\n"
+              << "    \"date\": \"" << date << "\",\n"
+              << "    \"library\": \"ariel::MyContainer\",\n"
+              << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+              << "    \"checked_iterators\": " << (checked_iterators ? "true" : "false") << "\n"
+              << "  },\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::cout << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+                  << ", \"items_per_iteration\": " << r.items_per_iteration
+                  << ", \"real_time\": " << r.ns_per_item << ", \"time_unit\": \"ns\""
+                  << (r.label.empty() ? "" : ", \"label\": \"" + r.label + "\"") << "}"
+                  << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    std::cout << "  ]\n}\n";
+}
+
+bool parse_flag(const char* arg, const char* flag, std::string& value) {
+    size_t len = std::strlen(flag);
+    if (std::strncmp(arg, flag, len) != 0 || arg[len] != '=') return false;
+    value = arg + len + 1;
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string value;
+        if (parse_flag(argv[i], "--min_n", value)) opt.min_n = std::stoull(value);
+        else if (parse_flag(argv[i], "--max_n", value)) opt.max_n = std::stoull(value);
+        else if (parse_flag(argv[i], "--min_time", value)) opt.min_time = std::stod(value);
+        else if (parse_flag(argv[i], "--threads", value)) opt.threads = std::stoul(value);
+        else if (parse_flag(argv[i], "--filter", value)) opt.filter = value;
+        else {
+            std::cerr << "unknown argument: " << argv[i] << "\n";
+            return 1;
+        }
+    }
+
+    bench_type<int>(opt, "int");
+    bench_type<double>(opt, "double");
+    bench_type<std::string>(opt, "string");
+    bench_concurrent_readers(opt);
+    bench_append_buffer(opt);
+    bench_persistence(opt);
+
+    print_json();
+    return 0;
+}
@@ -2,9 +2,24 @@
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "MyContainer.hpp"
+#include "ConcurrentMyContainer.hpp"
+#include "AppendBuffer.hpp"
+#include "MappedContainer.hpp"
 #include "doctest.h"
 #include <sstream>
 #include <string>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <atomic>
+#include <memory_resource>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#if __has_include(<ranges>)
+#include <ranges>
+#endif
 
 using namespace ariel;
 
@@ -38,6 +53,41 @@ TEST_CASE("Core behaviour: ctor / copy / size / <<") {
         CHECK(b.size() == 2);
     }
 
+    SUBCASE("Move-constructor steals storage and leaves source empty") {
+        MyContainer<std::string> src;
+        src.add("alpha"); src.add("beta");
+        const std::string* storage = &*src.begin_order();
+
+        MyContainer<std::string> dst(std::move(src));
+        CHECK(dst.size() == 2);
+        CHECK(&*dst.begin_order() == storage);
+        CHECK(src.size() == 0);
+        CHECK(src.begin_ascending_order() == src.end_ascending_order());
+        CHECK(std::is_nothrow_move_constructible<MyContainer<std::string>>::value);
+    }
+
+    SUBCASE("Move-assignment and swap exchange in O(1)") {
+        MyContainer<int> a, b;
+        a.add(3); a.add(1);
+        b.add(9);
+        CHECK(*a.begin_ascending_order() == 1);
+
+        swap(a, b);
+        CHECK(a.size() == 1);
+        CHECK(*a.begin_ascending_order() == 9);
+        CHECK(*b.begin_ascending_order() == 1);
+
+        b = std::move(a);
+        CHECK(b.size() == 1);
+        CHECK(*b.begin_descending_order() == 9);
+        CHECK(std::is_nothrow_move_assignable<MyContainer<int>>::value);
+
+        std::vector<MyContainer<int>> stages;
+        stages.push_back(std::move(b));
+        stages.emplace_back();
+        CHECK(stages[0].size() == 1);
+    }
+
     SUBCASE("Streaming operator formats correctly") {
         MyContainer<int> nums;
         std::ostringstream oss;
@@ -332,3 +382,1907 @@ TEST_CASE("Boundary & error scenarios") {
 }
 
 }
+
+/* ════════════════════════════════
+   11. Shared sorted index (cache & invalidation)
+   ════════════════════════════════ */
+TEST_CASE("Sorted views share one cached index") {
+
+    MyContainer<int> c; for(int v: {5,1,4}) c.add(v);
+
+    SUBCASE("Ascending, descending and side-cross agree on one sort") {
+        std::vector<int> asc, desc, cross;
+        for(auto it=c.begin_ascending_order(); it!=c.end_ascending_order(); ++it) asc.push_back(*it);
+        for(auto it=c.begin_descending_order(); it!=c.end_descending_order(); ++it) desc.push_back(*it);
+        for(auto it=c.begin_side_cross_order(); it!=c.end_side_cross_order(); ++it) cross.push_back(*it);
+        CHECK(asc == std::vector<int>{1,4,5});
+        CHECK(desc == std::vector<int>{5,4,1});
+        CHECK(cross == std::vector<int>{1,5,4});
+    }
+
+    SUBCASE("add() invalidates the cached order") {
+        CHECK(*c.begin_ascending_order() == 1);
+        c.add(0);
+        CHECK(*c.begin_ascending_order() == 0);
+        CHECK(*c.begin_descending_order() == 5);
+    }
+
+    SUBCASE("remove() invalidates the cached order") {
+        CHECK(*c.begin_descending_order() == 5);
+        c.remove(5);
+        CHECK(*c.begin_descending_order() == 4);
+        CHECK(c.begin_ascending_order() != c.end_ascending_order());
+    }
+
+    SUBCASE("Copies carry an independent cache") {
+        CHECK(*c.begin_ascending_order() == 1);
+        MyContainer<int> copy(c);
+        copy.remove(1);
+        CHECK(*copy.begin_ascending_order() == 4);
+        CHECK(*c.begin_ascending_order() == 1);
+    }
+}
+
+/* ════════════════════════════════
+   12. Non-owning iterators (pointer + position)
+   ════════════════════════════════ */
+TEST_CASE("Iterators are a few words, independent of container size") {
+
+    using S = MyContainer<std::string>;
+
+    SUBCASE("Iterator objects hold no element storage") {
+        // Checked builds add one word: the modification epoch the iterator was made at.
+        const size_t limit = 2 * sizeof(void*) + (ariel::checked_iterators ? sizeof(size_t) : 0);
+        CHECK(sizeof(S::Order)           <= limit);
+        CHECK(sizeof(S::AscendingOrder)  <= limit);
+        CHECK(sizeof(S::DescendingOrder) <= limit);
+        CHECK(sizeof(S::ReverseOrder)    <= limit);
+        CHECK(sizeof(S::SideCrossOrder)  <= limit);
+        CHECK(sizeof(S::MiddleOutOrder)  <= limit);
+    }
+
+    SUBCASE("Reverse and middle-out read the live container") {
+        S words; for (const char* w : {"a", "b", "c"}) words.add(w);
+        auto rev = words.begin_reverse_order();
+        auto mid = words.begin_middle_out_order();
+        CHECK(&*rev == &*words.begin_order() + 2);
+        CHECK(&*mid == &*words.begin_order() + 1);
+    }
+
+    SUBCASE("Post-increment on a large container stays correct") {
+        MyContainer<int> big; for (int i = 0; i < 1000; ++i) big.add(i);
+        auto it = big.begin_reverse_order();
+        auto old = it++;
+        CHECK(*old == 999);
+        CHECK(*it == 998);
+    }
+}
+
+/* ════════════════════════════════
+   13. Benchmark – linear traversal at n = 10^5
+   ════════════════════════════════ */
+namespace {
+
+/// Run a full begin..end traversal, count its steps and return the elapsed time in microseconds.
+template <typename Begin, typename End>
+double traversal_micros(Begin begin, End end, long long& checksum, size_t& steps) {
+    auto start = std::chrono::steady_clock::now();
+    auto stop_at = end();
+    for (auto it = begin(); it != stop_at; ++it) {
+        checksum += *it;
+        ++steps;
+    }
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(stop - start).count();
+}
+
+/// Comparator that counts how often it is called.
+struct CountingLess {
+    size_t* calls;
+    bool operator()(int a, int b) const { ++*calls; return a < b; }
+};
+
+/// An int whose operator== counts its calls, to measure the old snapshot equality.
+struct EqualityCounted {
+    static inline size_t calls = 0;
+    int v;
+    bool operator==(const EqualityCounted& other) const { ++calls; return v == other.v; }
+};
+
+}  // namespace
+
+TEST_CASE("Benchmark: O(1) iterator equality keeps traversal linear") {
+
+    const int n = 100000;
+    size_t comparisons = 0;
+    MyContainer<int, CountingLess> c(CountingLess{&comparisons});
+    for (int i = 0; i < n; ++i) c.add((i * 7919) % n);
+
+    // Baseline: the old iterators compared their element snapshots, one whole-vector
+    // `sorted == other.sorted` per end check. Sample that compare, counted and timed.
+    std::vector<EqualityCounted> snapshot_a(n), snapshot_b(n);
+    for (int i = 0; i < n; ++i) snapshot_a[i].v = snapshot_b[i].v = i;
+    const int samples = 20;
+    int equal = 0;
+    EqualityCounted::calls = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < samples; ++i) equal += (snapshot_a == snapshot_b);
+    auto stop = std::chrono::steady_clock::now();
+    const size_t reads_per_step = EqualityCounted::calls / samples;
+    const double micros_per_step = std::chrono::duration<double, std::micro>(stop - start).count() / samples;
+    CHECK(equal == samples);
+    CHECK(reads_per_step == static_cast<size_t>(n));
+
+    // Build the sorted index up front so the traversals below measure stepping only.
+    c.begin_ascending_order();
+    size_t sort_comparisons = comparisons;
+    size_t log_n = 0;
+    while ((size_t(1) << log_n) < static_cast<size_t>(n)) ++log_n;
+    CHECK(sort_comparisons <= 4 * static_cast<size_t>(n) * log_n);
+
+    comparisons = 0;
+    long long checksum = 0;
+    size_t steps = 0;
+    double order = traversal_micros([&] { return c.begin_order(); }, [&] { return c.end_order(); }, checksum, steps);
+    double asc = traversal_micros([&] { return c.begin_ascending_order(); }, [&] { return c.end_ascending_order(); }, checksum, steps);
+    double desc = traversal_micros([&] { return c.begin_descending_order(); }, [&] { return c.end_descending_order(); }, checksum, steps);
+    double rev = traversal_micros([&] { return c.begin_reverse_order(); }, [&] { return c.end_reverse_order(); }, checksum, steps);
+    double cross = traversal_micros([&] { return c.begin_side_cross_order(); }, [&] { return c.end_side_cross_order(); }, checksum, steps);
+    double mid = traversal_micros([&] { return c.begin_middle_out_order(); }, [&] { return c.end_middle_out_order(); }, checksum, steps);
+
+    MESSAGE("n = " << n << ", sort comparisons " << sort_comparisons);
+    MESSAGE("old snapshot equality: " << reads_per_step << " element compares per step, so "
+            << static_cast<double>(reads_per_step) * static_cast<double>(steps) << " for these traversals (~"
+            << micros_per_step * static_cast<double>(steps) / 1000 << " ms); now 0");
+    MESSAGE("measured traversal (ms): order " << order / 1000 << ", ascending " << asc / 1000
+            << ", descending " << desc / 1000 << ", reverse " << rev / 1000
+            << ", side-cross " << cross / 1000 << ", middle-out " << mid / 1000);
+
+    // Six full traversals take exactly 6n steps and compare no elements: each
+    // iterator step and end check is O(1), independent of n.
+    CHECK(steps == 6 * static_cast<size_t>(n));
+    CHECK(comparisons == 0);
+    CHECK(checksum == 6LL * (long long)n * (n - 1) / 2);
+}
+
+/* ════════════════════════════════
+   14. Bulk removal (remove_if / remove_all)
+   ════════════════════════════════ */
+TEST_CASE("Bulk removal: remove_if / remove_all") {
+
+    SUBCASE("remove keeps the relative order of survivors") {
+        MyContainer<int> c; for (int v : {3, 1, 3, 2, 3, 4}) c.add(v);
+        c.remove(3);
+        std::ostringstream oss; oss << c;
+        CHECK(oss.str() == "{1, 2, 4}");
+    }
+
+    SUBCASE("remove of a hot key with many duplicates") {
+        MyContainer<int> c;
+        for (int i = 0; i < 20000; ++i) c.add(i % 4 == 0 ? i : 7);
+        c.remove(7);
+        CHECK(c.size() == 5000);
+        CHECK(*c.begin_descending_order() == 19996);
+    }
+
+    SUBCASE("remove_if returns the number removed and never throws") {
+        MyContainer<int> c; for (int i = 1; i <= 10; ++i) c.add(i);
+        CHECK(c.remove_if([](int v) { return v % 2 == 0; }) == 5);
+        CHECK(c.remove_if([](int v) { return v > 100; }) == 0);
+        CHECK(c.size() == 5);
+        CHECK(*c.begin_descending_order() == 9);
+    }
+
+    SUBCASE("remove_all drops several values at once") {
+        MyContainer<std::string> s;
+        for (const char* w : {"a", "b", "c", "a", "d", "b"}) s.add(w);
+        std::vector<std::string> drop{"a", "b", "zzz"};
+        CHECK(s.remove_all(drop) == 4);
+        std::ostringstream oss; oss << s;
+        CHECK(oss.str() == "{c, d}");
+        CHECK(s.remove_all(std::vector<std::string>{}) == 0);
+    }
+}
+
+/* ════════════════════════════════
+   15. Move-aware insertion (add&&, emplace, reserve, add_range)
+   ════════════════════════════════ */
+namespace {
+
+/// Counts copies so tests can prove an insertion path moved instead of copied.
+struct CopyCounter {
+    static int copies;
+    int value = 0;
+    CopyCounter(int v = 0) : value(v) {}
+    CopyCounter(const CopyCounter& other) : value(other.value) { ++copies; }
+    CopyCounter(CopyCounter&&) noexcept = default;
+    CopyCounter& operator=(const CopyCounter& other) { value = other.value; ++copies; return *this; }
+    CopyCounter& operator=(CopyCounter&&) noexcept = default;
+    bool operator==(const CopyCounter& other) const { return value == other.value; }
+    bool operator<(const CopyCounter& other) const { return value < other.value; }
+};
+int CopyCounter::copies = 0;
+
+}  // namespace
+
+TEST_CASE("Move-aware insertion") {
+
+    SUBCASE("add(T&&) moves strings in") {
+        MyContainer<std::string> s;
+        std::string big(1000, 'x');
+        s.add(std::move(big));
+        CHECK(s.size() == 1);
+        CHECK(*s.begin_order() == std::string(1000, 'x'));
+    }
+
+    SUBCASE("add(T&&) and emplace make no copies") {
+        CopyCounter::copies = 0;
+        MyContainer<CopyCounter> c;
+        c.reserve(3);
+        c.add(CopyCounter(1));
+        c.emplace(2);
+        CopyCounter three(3);
+        c.add(std::move(three));
+        CHECK(c.size() == 3);
+        CHECK(CopyCounter::copies == 0);
+        CHECK((*c.begin_descending_order()).value == 3);
+    }
+
+    SUBCASE("add_range with move iterators makes no copies") {
+        CopyCounter::copies = 0;
+        std::vector<CopyCounter> batch{CopyCounter(5), CopyCounter(4)};
+        CopyCounter::copies = 0;
+        MyContainer<CopyCounter> c;
+        c.add_range(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+        CHECK(c.size() == 2);
+        CHECK(CopyCounter::copies == 0);
+        CHECK((*c.begin_ascending_order()).value == 4);
+    }
+
+    SUBCASE("Repeated add_range keeps geometric growth") {
+        MyContainer<int> c;
+        std::vector<int> batch(10, 1);
+        int reallocations = 0;
+        const int* last = nullptr;
+        for (int i = 0; i < 1000; ++i) {
+            c.add_range(batch.begin(), batch.end());
+            const int* now = &*c.begin_order();
+            if (now != last) { ++reallocations; last = now; }
+        }
+        CHECK(c.size() == 10000);
+        CHECK(reallocations <= 15);
+    }
+
+    SUBCASE("add_range accepts input iterators") {
+        std::istringstream in("3 1 2");
+        MyContainer<int> c;
+        c.add_range(std::istream_iterator<int>(in), std::istream_iterator<int>());
+        std::ostringstream oss; oss << c;
+        CHECK(oss.str() == "{3, 1, 2}");
+    }
+}
+
+/* ════════════════════════════════
+   16. Bounds-check policy
+   ════════════════════════════════ */
+TEST_CASE("Bounds-check policy follows the build mode") {
+
+    SUBCASE("Debug test build keeps the checks") {
+#if !defined(NDEBUG) && ARIEL_CHECKED_ITERATORS
+        CHECK(ariel::checked_iterators);
+        MyContainer<int> c;
+        CHECK_THROWS_AS(*c.begin_reverse_order(), std::out_of_range);
+#else
+        CHECK_FALSE(ariel::checked_iterators);
+#endif
+    }
+
+    SUBCASE("Iterators visit the same elements as a raw loop over the storage") {
+        // Timing lives in the -O3 bench: `make bench_checks` runs it checked and unchecked.
+        const int n = 100000;
+        MyContainer<int> c;
+        c.reserve(n);
+        for (int i = 0; i < n; ++i) c.add(i);
+
+        long long via_iterator = 0, via_index = 0;
+        for (auto it = c.begin_order(), end = c.end_order(); it != end; ++it) via_iterator += *it;
+        const int* raw = &*c.begin_order();
+        for (size_t i = 0; i < c.size(); ++i) via_index += raw[i];
+        CHECK(via_iterator == via_index);
+    }
+}
+
+/* ════════════════════════════════
+   17. Incremental sorted index upkeep
+   ════════════════════════════════ */
+namespace {
+
+template <typename T>
+std::vector<T> ascending_of(MyContainer<T>& c) {
+    std::vector<T> out;
+    for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it) out.push_back(*it);
+    return out;
+}
+
+template <typename T>
+std::vector<T> sorted_copy(MyContainer<T>& c) {
+    std::vector<T> out;
+    for (auto it = c.begin_order(); it != c.end_order(); ++it) out.push_back(*it);
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+}  // namespace
+
+TEST_CASE("Sorted index is maintained across add/remove") {
+
+    SUBCASE("Interleaved single inserts and ordered scans") {
+        MyContainer<int> c;
+        for (int i = 0; i < 200; ++i) {
+            c.add((i * 37) % 101);
+            CHECK(*c.begin_ascending_order() == *std::min_element(&*c.begin_order(), &*c.begin_order() + c.size()));
+        }
+        CHECK(ascending_of(c) == sorted_copy(c));
+    }
+
+    SUBCASE("Small batches are merged, large batches rebuild") {
+        MyContainer<int> c;
+        for (int v : {50, 10, 40}) c.add(v);
+        CHECK(ascending_of(c) == std::vector<int>{10, 40, 50});
+
+        std::vector<int> small{45, 5};
+        c.add_range(small.begin(), small.end());
+        CHECK(ascending_of(c) == std::vector<int>{5, 10, 40, 45, 50});
+
+        std::vector<int> large;
+        for (int i = 100; i > 80; --i) large.push_back(i);
+        c.add_range(large.begin(), large.end());
+        CHECK(ascending_of(c) == sorted_copy(c));
+        CHECK(c.size() == 25);
+    }
+
+    SUBCASE("remove / remove_if / remove_all keep the index consistent") {
+        MyContainer<std::string> s;
+        for (const char* w : {"pear", "fig", "apple", "fig", "kiwi", "date"}) s.add(w);
+        CHECK(ascending_of(s).front() == "apple");
+
+        s.remove("fig");
+        CHECK(ascending_of(s) == std::vector<std::string>{"apple", "date", "kiwi", "pear"});
+
+        s.remove_if([](const std::string& w) { return w.size() == 4 && w != "kiwi"; });
+        CHECK(ascending_of(s) == std::vector<std::string>{"apple", "kiwi"});
+
+        s.emplace(3, 'b');
+        s.remove_all(std::vector<std::string>{"apple"});
+        CHECK(ascending_of(s) == std::vector<std::string>{"bbb", "kiwi"});
+        CHECK(*s.begin_descending_order() == "kiwi");
+    }
+
+    SUBCASE("Randomised mix matches a fresh sort") {
+        MyContainer<int> c;
+        unsigned state = 12345;
+        auto next = [&state] { state = state * 1103515245u + 12345u; return (state >> 8) % 50; };
+        for (int round = 0; round < 300; ++round) {
+            unsigned op = next() % 4;
+            if (op < 2) {
+                c.add(static_cast<int>(next()));
+            } else if (op == 2) {
+                std::vector<int> batch{static_cast<int>(next()), static_cast<int>(next())};
+                c.add_range(batch.begin(), batch.end());
+            } else {
+                c.remove_if([v = static_cast<int>(next())](int x) { return x == v; });
+            }
+            if (round % 7 == 0) REQUIRE(ascending_of(c) == sorted_copy(c));
+        }
+        CHECK(ascending_of(c) == sorted_copy(c));
+    }
+}
+
+/* ════════════════════════════════
+   18. Index-mapped side-cross / middle-out (random access)
+   ════════════════════════════════ */
+TEST_CASE("SideCross and MiddleOut jump in O(1)") {
+
+    MyContainer<int> c; for (int v : {7, 15, 6, 1, 2, 9}) c.add(v);
+
+    SUBCASE("it[k] matches walking k steps") {
+        auto cross = c.begin_side_cross_order();
+        auto mid = c.begin_middle_out_order();
+        std::vector<int> walked_cross, walked_mid, jumped_cross, jumped_mid;
+        for (auto it = cross; it != c.end_side_cross_order(); ++it) walked_cross.push_back(*it);
+        for (auto it = mid; it != c.end_middle_out_order(); ++it) walked_mid.push_back(*it);
+        for (size_t k = 0; k < c.size(); ++k) {
+            jumped_cross.push_back(cross[k]);
+            jumped_mid.push_back(mid[k]);
+        }
+        CHECK(walked_cross == std::vector<int>{1, 15, 2, 9, 6, 7});
+        CHECK(walked_mid == std::vector<int>{1, 6, 2, 15, 9, 7});
+        CHECK(jumped_cross == walked_cross);
+        CHECK(jumped_mid == walked_mid);
+    }
+
+    SUBCASE("it + k lands in the middle of the traversal") {
+        auto it = c.begin_side_cross_order() + 3;
+        CHECK(*it == 9);
+        it += 3;
+        CHECK(it == c.end_side_cross_order());
+        CHECK(*(c.begin_middle_out_order() + 5) == 7);
+        CHECK(c.begin_middle_out_order() + 6 == c.end_middle_out_order());
+    }
+
+    SUBCASE("Jumping past the end is caught in checked builds") {
+        if (ariel::checked_iterators) {
+            CHECK_THROWS_AS(c.begin_side_cross_order() + 7, std::out_of_range);
+            CHECK_THROWS_AS(c.begin_middle_out_order()[6], std::out_of_range);
+        }
+    }
+
+    SUBCASE("Single and empty containers") {
+        MyContainer<int> one; one.add(4);
+        CHECK(*one.begin_side_cross_order() == 4);
+        CHECK(*one.begin_middle_out_order() == 4);
+        CHECK(one.begin_side_cross_order() + 1 == one.end_side_cross_order());
+        MyContainer<int> none;
+        CHECK(none.begin_side_cross_order() == none.end_side_cross_order());
+        CHECK(none.begin_middle_out_order() == none.end_middle_out_order());
+    }
+}
+
+/* ════════════════════════════════
+   19. Random-access iterator category (all orders)
+   ════════════════════════════════ */
+TEST_CASE("All orders are random-access iterators") {
+
+    using C = MyContainer<int>;
+    MyContainer<int> c; for (int v : {40, 10, 30, 20, 50}) c.add(v);
+
+    SUBCASE("iterator_traits report random access") {
+        using RA = std::random_access_iterator_tag;
+        CHECK(std::is_same<std::iterator_traits<C::Order>::iterator_category, RA>::value);
+        CHECK(std::is_same<std::iterator_traits<C::AscendingOrder>::iterator_category, RA>::value);
+        CHECK(std::is_same<std::iterator_traits<C::DescendingOrder>::iterator_category, RA>::value);
+        CHECK(std::is_same<std::iterator_traits<C::ReverseOrder>::iterator_category, RA>::value);
+        CHECK(std::is_same<std::iterator_traits<C::SideCrossOrder>::iterator_category, RA>::value);
+        CHECK(std::is_same<std::iterator_traits<C::MiddleOutOrder>::iterator_category, RA>::value);
+        CHECK(std::is_same<std::iterator_traits<C::Order>::value_type, int>::value);
+    }
+
+    SUBCASE("std::lower_bound and std::distance over the ascending view") {
+        auto begin = c.begin_ascending_order(), end = c.end_ascending_order();
+        CHECK(std::distance(begin, end) == 5);
+        auto hit = std::lower_bound(begin, end, 25);
+        CHECK(*hit == 30);
+        CHECK(hit - begin == 2);
+        CHECK(std::upper_bound(begin, end, 50) == end);
+        CHECK(std::binary_search(begin, end, 20));
+    }
+
+    SUBCASE("Decrement, negative offsets and ordering") {
+        auto end = c.end_descending_order();
+        auto last = end - 1;
+        CHECK(*last == 10);
+        CHECK(*--last == 20);
+        CHECK(last[-1] == 30);
+        CHECK(*(2 + c.begin_descending_order()) == 30);
+        CHECK(c.begin_descending_order() < end);
+        CHECK(end >= last);
+
+        std::vector<int> backwards;
+        for (auto it = c.end_reverse_order(); it != c.begin_reverse_order();) backwards.push_back(*--it);
+        CHECK(backwards == std::vector<int>{40, 10, 30, 20, 50});
+    }
+
+    SUBCASE("Standard algorithms work on every order") {
+        CHECK(std::is_sorted(c.begin_ascending_order(), c.end_ascending_order()));
+        CHECK(std::is_sorted(c.begin_descending_order(), c.end_descending_order(), std::greater<int>()));
+        std::vector<int> mid(c.begin_middle_out_order(), c.end_middle_out_order());
+        CHECK(mid == std::vector<int>{30, 10, 20, 40, 50});
+        CHECK(std::count_if(c.begin_side_cross_order(), c.end_side_cross_order(),
+                            [](int v) { return v > 15; }) == 4);
+        MyContainer<std::string> words; words.add("kiwi"); words.add("fig");
+        CHECK(words.begin_ascending_order()->size() == 3);
+    }
+
+    SUBCASE("Stepping before begin is caught in checked builds") {
+        if (ariel::checked_iterators) {
+            auto it = c.begin_order();
+            CHECK_THROWS_AS(--it, std::out_of_range);
+            CHECK_THROWS_AS(c.begin_ascending_order() - 1, std::out_of_range);
+        }
+    }
+}
+
+/* ════════════════════════════════
+   20. Parallel sort for the sorted views
+   ════════════════════════════════ */
+TEST_CASE("Opt-in parallel sort builds the same views") {
+
+    SUBCASE("Thread count is configurable and copied with the container") {
+        MyContainer<int> c;
+        CHECK(c.sort_threads() == 1);
+        c.set_sort_threads(4);
+        CHECK(c.sort_threads() == 4);
+        c.set_sort_threads(0);
+        CHECK(c.sort_threads() >= 1);
+        MyContainer<int> copy(c);
+        CHECK(copy.sort_threads() == c.sort_threads());
+    }
+
+    SUBCASE("Large container sorted on several threads") {
+        const int n = 200000;
+        MyContainer<int> serial, parallel;
+        parallel.set_sort_threads(4);
+        for (int i = 0; i < n; ++i) {
+            int v = (i * 7919) % 5003 - 2500;
+            serial.add(v);
+            parallel.add(v);
+        }
+        std::vector<int> expected(serial.begin_ascending_order(), serial.end_ascending_order());
+        std::vector<int> got(parallel.begin_ascending_order(), parallel.end_ascending_order());
+        CHECK(got == expected);
+        CHECK(std::is_sorted(got.begin(), got.end()));
+        CHECK(*parallel.begin_descending_order() == expected.back());
+    }
+
+    SUBCASE("Uneven run sizes with three threads") {
+        MyContainer<std::string> words;
+        words.set_sort_threads(3);
+        for (int i = 0; i < 70001; ++i) words.add(std::to_string((i * 31) % 70001));
+        CHECK(std::is_sorted(words.begin_ascending_order(), words.end_ascending_order()));
+        CHECK(*words.begin_ascending_order() == "0");
+    }
+}
+
+/* ════════════════════════════════
+   21. Radix-sort fast path for numeric types
+   ════════════════════════════════ */
+namespace {
+
+/// Ascending view of a container filled from values, as a plain vector.
+template <typename T>
+std::vector<T> ascending_from(const std::vector<T>& values) {
+    MyContainer<T> c;
+    c.add_range(values.begin(), values.end());
+    return std::vector<T>(c.begin_ascending_order(), c.end_ascending_order());
+}
+
+/// Deterministic pseudo-random values spread over the whole range of T.
+template <typename T>
+std::vector<T> scrambled(size_t n) {
+    std::vector<T> out;
+    unsigned long long state = 88172645463325252ULL;
+    for (size_t i = 0; i < n; ++i) {
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        T v;
+        std::memcpy(&v, &state, sizeof(T));
+        out.push_back(v);
+    }
+    return out;
+}
+
+}  // namespace
+
+TEST_CASE("Radix sort orders integers and floats like std::sort") {
+
+    SUBCASE("Signed and unsigned integers of every width") {
+        auto i32 = scrambled<int>(5000);
+        auto expect_i32 = i32; std::sort(expect_i32.begin(), expect_i32.end());
+        CHECK(ascending_from(i32) == expect_i32);
+
+        auto i64 = scrambled<long long>(5000);
+        i64.push_back(std::numeric_limits<long long>::min());
+        i64.push_back(std::numeric_limits<long long>::max());
+        auto expect_i64 = i64; std::sort(expect_i64.begin(), expect_i64.end());
+        CHECK(ascending_from(i64) == expect_i64);
+
+        auto u32 = scrambled<unsigned>(3000);
+        auto expect_u32 = u32; std::sort(expect_u32.begin(), expect_u32.end());
+        CHECK(ascending_from(u32) == expect_u32);
+
+        auto i8 = scrambled<signed char>(1000);
+        auto expect_i8 = i8; std::sort(expect_i8.begin(), expect_i8.end());
+        CHECK(ascending_from(i8) == expect_i8);
+
+        auto i16 = scrambled<short>(1000);
+        auto expect_i16 = i16; std::sort(expect_i16.begin(), expect_i16.end());
+        CHECK(ascending_from(i16) == expect_i16);
+    }
+
+    SUBCASE("Negative doubles, infinities and signed zeros") {
+        std::vector<double> d;
+        for (int i = 0; i < 1000; ++i) d.push_back((i * 37 % 1000 - 500) * 0.25);
+        d.push_back(-std::numeric_limits<double>::infinity());
+        d.push_back(std::numeric_limits<double>::infinity());
+        d.push_back(-0.0);
+        d.push_back(std::numeric_limits<double>::denorm_min());
+        d.push_back(-std::numeric_limits<double>::max());
+        auto expect = d; std::sort(expect.begin(), expect.end());
+        CHECK(ascending_from(d) == expect);
+
+        std::vector<float> f;
+        for (int i = 0; i < 600; ++i) f.push_back(static_cast<float>(300 - i) / 7.0f);
+        auto expect_f = f; std::sort(expect_f.begin(), expect_f.end());
+        CHECK(ascending_from(f) == expect_f);
+    }
+
+    SUBCASE("NaNs sort after every number, on both the radix and the small path") {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        for (size_t n : {size_t(10), size_t(1000)}) {
+            std::vector<double> d;
+            for (size_t i = 0; i < n; ++i) d.push_back(i % 3 == 0 ? (i % 2 ? nan : -nan) : double(n - i) - 5.0);
+            MyContainer<double> c;
+            c.add_range(d.begin(), d.end());
+            std::vector<double> asc(c.begin_ascending_order(), c.end_ascending_order());
+            auto first_nan = std::find_if(asc.begin(), asc.end(), [](double v) { return v != v; });
+            CHECK(std::is_sorted(asc.begin(), first_nan));
+            CHECK(std::all_of(first_nan, asc.end(), [](double v) { return v != v; }));
+            CHECK(static_cast<size_t>(asc.end() - first_nan) == (n + 2) / 3);
+            CHECK(*c.begin_descending_order() != *c.begin_descending_order());
+
+            c.add(-1e300);
+            c.add(nan);
+            CHECK(*c.begin_ascending_order() == -1e300);
+            CHECK(std::is_sorted(c.begin_ascending_order(), c.end_ascending_order() - (n + 2) / 3 - 1));
+        }
+    }
+
+    SUBCASE("Equal keys keep insertion order") {
+        MyContainer<int> c;
+        for (int i = 0; i < 1000; ++i) c.add(i % 10);
+        const int* base = &*c.begin_order();
+        auto it = c.begin_ascending_order();
+        for (int i = 0; i < 100; ++i, ++it) CHECK(&*it == base + 10 * i);
+    }
+
+    SUBCASE("Signed zeros are equal keys on both the radix and the small path") {
+        for (int n : {10, 300}) {
+            MyContainer<double> c;
+            c.set_stable_order(true);
+            for (int i = 0; i < n; ++i) c.add(i % 2 ? -0.0 : 0.0);
+            c.add(-1.0);
+            auto it = c.begin_ascending_order();
+            CHECK(*it == -1.0);
+            ++it;
+            for (int i = 0; i < n; ++i, ++it) CHECK(std::signbit(*it) == (i % 2 == 1));
+        }
+    }
+
+    SUBCASE("Radix passes split across sort threads give the serial permutation") {
+        auto i64 = scrambled<long long>(150001);
+        std::vector<double> d;
+        for (size_t i = 0; i < 150001; ++i) d.push_back(static_cast<double>((i * 7919) % 4001) * 0.5 - 1000.0);
+        for (unsigned threads : {2u, 3u, 8u}) {
+            MyContainer<long long> serial_i, parallel_i;
+            serial_i.add_range(i64.begin(), i64.end());
+            parallel_i.add_range(i64.begin(), i64.end());
+            parallel_i.set_sort_threads(threads);
+            MyContainer<double> serial_d, parallel_d;
+            serial_d.add_range(d.begin(), d.end());
+            parallel_d.add_range(d.begin(), d.end());
+            parallel_d.set_sort_threads(threads);
+
+            // Same element addresses in the same order: equal keys stay in insertion order.
+            auto address_order = [](const auto& c) {
+                const auto* base = &*c.begin_order();
+                std::vector<size_t> positions;
+                for (auto it = c.begin_ascending_order(); it != c.end_ascending_order(); ++it)
+                    positions.push_back(static_cast<size_t>(&*it - base));
+                return positions;
+            };
+            CHECK(address_order(parallel_i) == address_order(serial_i));
+            CHECK(address_order(parallel_d) == address_order(serial_d));
+        }
+    }
+}
+
+/* ════════════════════════════════
+   22. Custom comparator & key projection
+   ════════════════════════════════ */
+namespace {
+
+struct Employee {
+    std::string name;
+    int age;
+    double salary;
+    bool operator==(const Employee& other) const { return name == other.name; }
+    bool operator<(const Employee& other) const { return name < other.name; }
+};
+
+std::ostream& operator<<(std::ostream& os, const Employee& e) { return os << e.name; }
+
+/// Orders employees by age, youngest first.
+struct ByAge {
+    bool operator()(const Employee& a, const Employee& b) const { return a.age < b.age; }
+};
+
+/// A struct with no operator<: it can only be sorted through a projection.
+struct Reading {
+    int a;
+    double value;
+};
+
+}  // namespace
+
+TEST_CASE("Sorted orders honour Compare and projections") {
+
+    SUBCASE("std::greater flips every sorted order") {
+        MyContainer<int, std::greater<int>> c;
+        for (int v : {3, 1, 2, 5, 4}) c.add(v);
+        std::vector<int> asc(c.begin_ascending_order(), c.end_ascending_order());
+        std::vector<int> desc(c.begin_descending_order(), c.end_descending_order());
+        std::vector<int> cross(c.begin_side_cross_order(), c.end_side_cross_order());
+        CHECK(asc == std::vector<int>{5, 4, 3, 2, 1});
+        CHECK(desc == std::vector<int>{1, 2, 3, 4, 5});
+        CHECK(cross == std::vector<int>{5, 1, 4, 2, 3});
+        c.add(9);
+        CHECK(*c.begin_ascending_order() == 9);
+    }
+
+    SUBCASE("Struct container with a comparator type") {
+        MyContainer<Employee, ByAge> staff;
+        staff.add({"dana", 41, 10.0});
+        staff.add({"avi", 29, 30.0});
+        staff.add({"noa", 35, 20.0});
+        CHECK(staff.begin_ascending_order()->name == "avi");
+        CHECK(staff.begin_descending_order()->name == "dana");
+        std::ostringstream oss; oss << staff;
+        CHECK(oss.str() == "{dana, avi, noa}");
+    }
+
+    SUBCASE("Projection onto a member sorts by that field") {
+        MyContainer<Employee> staff;
+        staff.add({"dana", 41, 10.0});
+        staff.add({"avi", 29, 30.0});
+        staff.add({"noa", 35, 20.0});
+        staff.add({"gil", 29, 25.0});
+
+        std::vector<std::string> by_age;
+        for (auto it = staff.begin_ascending_order(&Employee::age); it != staff.end_ascending_order(&Employee::age); ++it)
+            by_age.push_back(it->name);
+        CHECK(by_age == std::vector<std::string>{"avi", "gil", "noa", "dana"});
+
+        auto richest = staff.begin_ascending_order([](const Employee& e) { return e.salary; }, std::greater<>());
+        CHECK(richest->name == "avi");
+        CHECK(richest[3].name == "dana");
+
+        auto by_name = staff.begin_ascending_order();
+        CHECK(by_name->name == "avi");
+    }
+
+    SUBCASE("Projected iterators are cheap to copy and random access") {
+        MyContainer<std::string> words;
+        for (const char* w : {"ccc", "a", "bb", "dddd"}) words.add(w);
+        auto length = [](const std::string& w) { return w.size(); };
+        auto by_len = words.begin_ascending_order(length);
+        auto end = words.end_ascending_order(length);
+        auto copy = by_len;
+        CHECK(end - copy == 4);
+        CHECK(*(copy + 2) == "ccc");
+        CHECK(std::is_sorted(by_len, end, [](const std::string& a, const std::string& b) { return a.size() < b.size(); }));
+        CHECK(sizeof(MyContainer<std::string>::ProjectedOrder) <=
+              4 * sizeof(void*) + (ariel::checked_iterators ? sizeof(size_t) : 0));
+    }
+
+    SUBCASE("Elements without operator< can be added and sorted by a projection") {
+        MyContainer<Reading> readings;
+        readings.add(Reading{3, 0.3});
+        Reading one{1, 0.1};
+        readings.add(one);
+        readings.emplace(Reading{2, 0.2});
+        std::vector<Reading> more{{5, 0.5}, {4, 0.4}};
+        readings.add_range(more.begin(), more.end());
+        CHECK(readings.remove_if([](const Reading& r) { return r.a == 5; }) == 1);
+
+        std::vector<int> by_a;
+        for (auto it = readings.begin_ascending_order(&Reading::a); it != readings.end_ascending_order(&Reading::a); ++it)
+            by_a.push_back(it->a);
+        CHECK(by_a == std::vector<int>{1, 2, 3, 4});
+        CHECK(readings.ascending(&Reading::value, std::greater<>()).front().a == 4);
+        MyContainer<Reading> copy(readings);
+        CHECK(copy.size() == 4);
+    }
+
+    SUBCASE("A standalone projected end only marks the end") {
+        MyContainer<int> c; for (int v : {3, 1, 2}) c.add(v);
+        auto neg = [](int v) { return -v; };
+        auto end = c.end_ascending_order(neg);
+        CHECK(end == c.begin_ascending_order(neg) + 3);
+        if (ariel::checked_iterators) {
+            CHECK_THROWS_AS(*(end - 1), std::logic_error);
+            auto last = end;
+            --last;
+            CHECK_THROWS_AS(*last, std::logic_error);
+        }
+    }
+}
+
+/* ════════════════════════════════
+   23. Stable ordering mode
+   ════════════════════════════════ */
+TEST_CASE("Stable ordering keeps insertion order among equal elements") {
+
+    auto names = [](auto begin, auto end) {
+        std::vector<std::string> out;
+        for (auto it = begin; it != end; ++it) out.push_back(it->name);
+        return out;
+    };
+
+    MyContainer<Employee, ByAge> staff;
+    staff.set_stable_order(true);
+    CHECK(staff.stable_order());
+    for (auto e : {Employee{"a", 30, 0}, Employee{"b", 20, 0}, Employee{"c", 30, 0},
+                   Employee{"d", 20, 0}, Employee{"e", 40, 0}, Employee{"f", 30, 0}}) {
+        staff.add(e);
+    }
+
+    SUBCASE("Ascending and descending both keep ties in insertion order") {
+        CHECK(names(staff.begin_ascending_order(), staff.end_ascending_order()) ==
+              std::vector<std::string>{"b", "d", "a", "c", "f", "e"});
+        CHECK(names(staff.begin_descending_order(), staff.end_descending_order()) ==
+              std::vector<std::string>{"e", "a", "c", "f", "b", "d"});
+    }
+
+    SUBCASE("Side-cross keeps ties in insertion order on both ends") {
+        CHECK(names(staff.begin_side_cross_order(), staff.end_side_cross_order()) ==
+              std::vector<std::string>{"b", "e", "d", "c", "a", "f"});
+
+        MyContainer<Employee, ByAge> pairs;
+        pairs.set_stable_order(true);
+        for (auto e : {Employee{"5:0", 5, 0}, Employee{"5:1", 5, 0}, Employee{"1:2", 1, 0}, Employee{"1:3", 1, 0}})
+            pairs.add(e);
+        CHECK(names(pairs.begin_side_cross_order(), pairs.end_side_cross_order()) ==
+              std::vector<std::string>{"1:2", "5:0", "1:3", "5:1"});
+
+        // Against a reference: the front takes the first half of the stable ascending
+        // order, the back the rest from the largest down, each tie group oldest first.
+        for (int n = 1; n <= 40; ++n) {
+            MyContainer<Employee, ByAge> c;
+            c.set_stable_order(true);
+            for (int i = 0; i < n; ++i) c.add({std::to_string(i), (i * 7) % 4, 0});
+            std::vector<Employee> asc(c.begin_ascending_order(), c.end_ascending_order());
+            size_t half = (asc.size() + 1) / 2;
+            std::vector<Employee> back(asc.begin() + half, asc.end());
+            std::stable_sort(back.begin(), back.end(), [](const Employee& a, const Employee& b) { return a.age > b.age; });
+            std::vector<std::string> expected;
+            for (size_t k = 0; k < half; ++k) {
+                expected.push_back(asc[k].name);
+                if (k < back.size()) expected.push_back(back[k].name);
+            }
+            CHECK(names(c.begin_side_cross_order(), c.end_side_cross_order()) == expected);
+        }
+    }
+
+    SUBCASE("Stability survives incremental add and remove") {
+        CHECK(staff.begin_descending_order()->name == "e");
+        staff.add({"g", 20, 0});
+        staff.add({"h", 40, 0});
+        CHECK(names(staff.begin_descending_order(), staff.end_descending_order()) ==
+              std::vector<std::string>{"e", "h", "a", "c", "f", "b", "d", "g"});
+        staff.remove({"c", 0, 0});
+        CHECK(names(staff.begin_ascending_order(), staff.end_ascending_order()) ==
+              std::vector<std::string>{"b", "d", "g", "a", "f", "e", "h"});
+        CHECK(names(staff.begin_descending_order(), staff.end_descending_order()) ==
+              std::vector<std::string>{"e", "h", "a", "f", "b", "d", "g"});
+    }
+
+    SUBCASE("Stable mode on a large container with several sort threads") {
+        MyContainer<std::string> words;
+        words.set_stable_order(true);
+        words.set_sort_threads(3);
+        for (int i = 0; i < 60000; ++i) words.add(std::to_string(i % 7));
+        const std::string* base = &*words.begin_order();
+        auto asc = words.begin_ascending_order();
+        auto desc = words.begin_descending_order();
+        bool in_order = true;
+        for (int k = 0; k + 1 < 8571; ++k) {
+            in_order = in_order && &asc[k] < &asc[k + 1] && &desc[k] < &desc[k + 1];
+        }
+        CHECK(in_order);
+        CHECK(&*asc == base);
+        CHECK(&*desc == base + 6);
+    }
+
+    SUBCASE("Turning stable mode off again still sorts correctly") {
+        staff.set_stable_order(false);
+        CHECK_FALSE(staff.stable_order());
+        CHECK(staff.begin_ascending_order()->age == 20);
+        CHECK(staff.begin_descending_order()->age == 40);
+    }
+}
+
+/* ════════════════════════════════
+   24. ConcurrentMyContainer – reader/writer locking
+   ════════════════════════════════ */
+TEST_CASE("ConcurrentMyContainer serializes writers and shares readers") {
+
+    SUBCASE("Single-threaded API mirrors MyContainer") {
+        ConcurrentMyContainer<int> c;
+        c.add(3); c.add(1); c.emplace(2);
+        std::vector<int> more{5, 4};
+        c.add_range(more.begin(), more.end());
+        CHECK(c.size() == 5);
+        c.remove(5);
+        CHECK_THROWS_AS(c.remove(5), std::invalid_argument);
+        CHECK(c.remove_if([](int v) { return v > 3; }) == 1);
+
+        auto view = c.read();
+        std::vector<int> asc(view.begin_ascending_order(), view.end_ascending_order());
+        std::vector<int> desc(view.begin_descending_order(), view.end_descending_order());
+        CHECK(asc == std::vector<int>{1, 2, 3});
+        CHECK(desc == std::vector<int>{3, 2, 1});
+        CHECK(view.size() == 3);
+        std::ostringstream oss; oss << view;
+        CHECK(oss.str() == "{3, 1, 2}");
+    }
+
+    SUBCASE("Concurrent writers and readers see consistent snapshots") {
+        ConcurrentMyContainer<int> c;
+        const int writers = 4, per_writer = 500, readers = 4, views_per_reader = 50;
+        std::atomic<int> inconsistent{0}, snapshots{0};
+
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&] {
+                for (int k = 0; k < views_per_reader; ++k) {
+                    {
+                        auto view = c.read();
+                        size_t n = view.size();
+                        auto begin = view.begin_ascending_order(), end = view.end_ascending_order();
+                        if (static_cast<size_t>(end - begin) != n || !std::is_sorted(begin, end)) ++inconsistent;
+                        size_t counted = 0;
+                        for (auto it = view.begin_side_cross_order(); it != view.end_side_cross_order(); ++it) ++counted;
+                        if (counted != n) ++inconsistent;
+                        ++snapshots;
+                    }
+                    std::this_thread::yield();
+                }
+            });
+        }
+        for (int w = 0; w < writers; ++w) {
+            threads.emplace_back([&c, w] {
+                for (int i = 0; i < per_writer; ++i) c.add(w * per_writer + (i * 7) % per_writer);
+            });
+        }
+        for (auto& t : threads) t.join();
+
+        CHECK(inconsistent == 0);
+        CHECK(snapshots == readers * views_per_reader);
+        CHECK(c.size() == static_cast<size_t>(writers * per_writer));
+        auto view = c.read();
+        CHECK(*view.begin_ascending_order() == 0);
+        CHECK(*view.begin_descending_order() == writers * per_writer - 1);
+    }
+}
+
+/* ════════════════════════════════
+   25. AppendBuffer – lock-free multi-producer ingest
+   ════════════════════════════════ */
+namespace {
+struct Fragile {
+    int value;
+    explicit Fragile(int v) : value(v) {
+        if (v < 0) throw std::runtime_error("negative");
+    }
+    bool operator<(const Fragile& other) const { return value < other.value; }
+    bool operator==(const Fragile& other) const { return value == other.value; }
+};
+ostream& operator<<(ostream& os, const Fragile& f) { return os << f.value; }
+}
+
+TEST_CASE("AppendBuffer collects concurrent pushes and publishes them") {
+
+    SUBCASE("Single producer keeps claim order and size is exact after publish") {
+        AppendBuffer<int> buffer;
+        MyContainer<int> c;
+        c.add(100);
+        for (int i = 0; i < 5; ++i) buffer.push(5 - i);
+        CHECK(buffer.pending() == 5);
+        CHECK(c.size() == 1);
+        CHECK(buffer.publish(c) == 5);
+        CHECK(buffer.pending() == 0);
+        CHECK(c.size() == 6);
+        std::vector<int> order(c.begin_order(), c.end_order());
+        CHECK(order == std::vector<int>{100, 5, 4, 3, 2, 1});
+        CHECK(buffer.publish(c) == 0);
+    }
+
+    SUBCASE("Publishing keeps an already built sorted index valid") {
+        AppendBuffer<int> buffer;
+        MyContainer<int> c;
+        c.add(4); c.add(2);
+        c.begin_ascending_order();
+        buffer.push(3); buffer.push(1);
+        buffer.publish(c);
+        std::vector<int> asc(c.begin_ascending_order(), c.end_ascending_order());
+        CHECK(asc == std::vector<int>{1, 2, 3, 4});
+    }
+
+    SUBCASE("Elements spanning several segments and moved-in strings") {
+        AppendBuffer<std::string> buffer;
+        MyContainer<std::string> c;
+        const size_t n = 2 * AppendBuffer<std::string>::segment_size + 17;
+        for (size_t i = 0; i < n; ++i) buffer.push(std::to_string(i));
+        CHECK(buffer.publish(c) == n);
+        CHECK(c.size() == n);
+        CHECK(*c.begin_order() == "0");
+        CHECK(*(c.end_order() - 1) == std::to_string(n - 1));
+    }
+
+    SUBCASE("A constructor that throws leaves no hole in the published data") {
+        AppendBuffer<Fragile> buffer;
+        MyContainer<Fragile> c;
+        buffer.emplace(1);
+        CHECK_THROWS_AS(buffer.emplace(-1), std::runtime_error);
+        buffer.emplace(2);
+        CHECK(buffer.publish(c) == 2);
+        std::ostringstream oss; oss << c;
+        CHECK(oss.str() == "{1, 2}");
+    }
+
+    SUBCASE("Many producers with publishes running concurrently") {
+        AppendBuffer<int> buffer;
+        MyContainer<int> c;
+        const int producers = 8, per_producer = 20000;
+        std::atomic<int> running{producers};
+
+        std::thread publisher([&] {
+            while (running.load() > 0) {
+                buffer.publish(c);
+                std::this_thread::yield();
+            }
+        });
+        std::vector<std::thread> pool;
+        for (int p = 0; p < producers; ++p) {
+            pool.emplace_back([&, p] {
+                size_t backlog = 0;
+                for (int i = 0; i < per_producer; ++i) {
+                    buffer.push(p * per_producer + i);
+                    if (i % 64 == 0) backlog = std::max(backlog, buffer.pending());  // races with publish()
+                }
+                CHECK(backlog <= static_cast<size_t>(producers) * per_producer);
+                --running;
+            });
+        }
+        for (auto& t : pool) t.join();
+        publisher.join();
+        buffer.publish(c);
+
+        const size_t total = static_cast<size_t>(producers) * per_producer;
+        CHECK(buffer.pending() == 0);
+        REQUIRE(c.size() == total);
+        std::vector<int> asc(c.begin_ascending_order(), c.end_ascending_order());
+        bool every_value_once = true;
+        for (size_t i = 0; i < total; ++i) every_value_once &= (asc[i] == static_cast<int>(i));
+        CHECK(every_value_once);
+    }
+}
+
+/* ════════════════════════════════
+   26. Chunked snapshots
+   ════════════════════════════════ */
+namespace {
+/// Element that counts its live instances, to see which copies a container keeps.
+struct LiveCounted {
+    static inline int live = 0;
+    int v;
+    LiveCounted(int value) : v(value) { ++live; }
+    LiveCounted(const LiveCounted& other) : v(other.v) { ++live; }
+    LiveCounted& operator=(const LiveCounted&) = default;
+    ~LiveCounted() { --live; }
+    bool operator<(const LiveCounted& other) const { return v < other.v; }
+};
+}
+
+TEST_CASE("snapshot() gives a consistent immutable version") {
+
+    SUBCASE("A snapshot does not see later mutations") {
+        MyContainer<int> c;
+        c.add(3); c.add(1); c.add(2);
+        auto snap = c.snapshot();
+        c.add(9);
+        c.remove(1);
+        CHECK(snap.size() == 3);
+        std::vector<int> seen(snap.begin_order(), snap.end_order());
+        CHECK(seen == std::vector<int>{3, 1, 2});
+        std::ostringstream oss; oss << snap;
+        CHECK(oss.str() == "{3, 1, 2}");
+        CHECK(c.snapshot().size() == 3);
+        CHECK(c.snapshot()[2] == 9);
+    }
+
+    SUBCASE("A snapshot outlives its container") {
+        MyContainer<std::string>::Snapshot snap;
+        {
+            MyContainer<std::string> c;
+            c.add("a"); c.add("b");
+            snap = c.snapshot();
+        }
+        CHECK(snap.size() == 2);
+        CHECK(snap[1] == "b");
+    }
+
+    SUBCASE("Untouched chunks are shared, touched chunks are copied") {
+        MyContainer<int> c;
+        const int n = 3 * 4096 + 10;
+        for (int i = 0; i < n; ++i) c.add(i);
+        auto first = c.snapshot();
+        auto again = c.snapshot();
+        CHECK(&first[0] == &again[0]);
+        CHECK(&first[n - 1] == &again[n - 1]);
+
+        c.add(n);
+        auto grown = c.snapshot();
+        CHECK(&first[0] == &grown[0]);
+        CHECK(&first[2 * 4096] == &grown[2 * 4096]);
+        CHECK(&first[n - 1] != &grown[n - 1]);
+        CHECK(grown.size() == static_cast<size_t>(n + 1));
+        CHECK(grown[n] == n);
+
+        c.remove(4096 + 5);
+        auto shrunk = c.snapshot();
+        CHECK(&first[0] == &shrunk[0]);
+        CHECK(&first[4096] != &shrunk[4096]);
+        CHECK(shrunk[4096 + 5] == 4096 + 6);
+        CHECK(first[4096 + 5] == 4096 + 5);
+    }
+
+    SUBCASE("Chunk copies are freed with the last snapshot holding them") {
+        MyContainer<LiveCounted> c;
+        c.reserve(5000);
+        for (int i = 0; i < 5000; ++i) c.add(LiveCounted(i));
+        const int stored = LiveCounted::live;
+        {
+            auto snap = c.snapshot();
+            CHECK(LiveCounted::live == 2 * stored);
+            auto again = c.snapshot();
+            CHECK(LiveCounted::live == 2 * stored);
+            CHECK(&snap[0] == &again[0]);
+        }
+        CHECK(LiveCounted::live == stored);
+        auto fresh = c.snapshot();
+        CHECK(fresh[4999].v == 4999);
+        CHECK(LiveCounted::live == 2 * stored);
+    }
+
+    SUBCASE("Removal before the sorted index is built also marks chunks stale") {
+        MyContainer<int> c;
+        c.add(1); c.add(2); c.add(3);
+        c.snapshot();
+        CHECK(c.remove_if([](int v) { return v == 2; }) == 1);
+        auto snap = c.snapshot();
+        CHECK(std::vector<int>(snap.begin_order(), snap.end_order()) == std::vector<int>{1, 3});
+    }
+
+    SUBCASE("Copies share chunks; moved-from containers start over") {
+        MyContainer<int> c;
+        c.add(1); c.add(2);
+        auto snap = c.snapshot();
+        MyContainer<int> copy(c);
+        CHECK(&copy.snapshot()[0] == &snap[0]);
+        MyContainer<int> moved(std::move(c));
+        CHECK(moved.snapshot().size() == 2);
+        CHECK(c.snapshot().size() == 0);
+    }
+
+    SUBCASE("Snapshot iterators are random access") {
+        MyContainer<int> c;
+        for (int v : {5, 3, 8, 1}) c.add(v);
+        auto snap = c.snapshot();
+        auto it = snap.begin_order();
+        CHECK(snap.end_order() - it == 4);
+        CHECK(it[2] == 8);
+        CHECK(*(it + 3) == 1);
+        CHECK(std::is_same_v<std::iterator_traits<decltype(it)>::iterator_category,
+                             std::random_access_iterator_tag>);
+    }
+
+    SUBCASE("ConcurrentMyContainer snapshots can be scanned while writers run") {
+        ConcurrentMyContainer<int> c;
+        for (int i = 0; i < 100; ++i) c.add(i);
+        auto snap = c.snapshot();
+        std::thread writer([&c] { for (int i = 0; i < 1000; ++i) c.add(-i); });
+        long long sum = 0;
+        for (auto it = snap.begin_order(); it != snap.end_order(); ++it) sum += *it;
+        writer.join();
+        CHECK(sum == 4950);
+        CHECK(c.snapshot().size() == 1100);
+    }
+}
+
+/* ════════════════════════════════
+   27. Modification epoch – invalidated iterators
+   ════════════════════════════════ */
+TEST_CASE("Iterators detect modification of their container in checked builds") {
+    MyContainer<int> c;
+    for (int v : {4, 1, 3, 2}) c.add(v);
+
+    if (!ariel::checked_iterators) {
+        auto it = c.begin_order();
+        c.add(5);
+        CHECK(sizeof(it) == sizeof(void*) + sizeof(size_t));
+        return;
+    }
+
+    SUBCASE("add invalidates insertion-order and sorted iterators") {
+        auto order = c.begin_order();
+        auto asc = c.begin_ascending_order();
+        auto side = c.begin_side_cross_order();
+        c.add(0);
+        CHECK_THROWS_AS(*order, std::logic_error);
+        CHECK_THROWS_AS(++asc, std::logic_error);
+        CHECK_THROWS_AS(side[1], std::logic_error);
+        CHECK(*c.begin_ascending_order() == 0);
+    }
+
+    SUBCASE("remove invalidates, even iterators still in range") {
+        auto it = c.begin_order() + 1;
+        c.remove(4);
+        CHECK_THROWS_AS(*it, std::logic_error);
+        CHECK_THROWS_AS(it += 1, std::logic_error);
+        CHECK_THROWS_AS(--it, std::logic_error);
+    }
+
+    SUBCASE("A remove_if that removes nothing keeps iterators valid") {
+        auto it = c.begin_descending_order();
+        CHECK(c.remove_if([](int v) { return v > 100; }) == 0);
+        CHECK(*it == 4);
+    }
+
+    SUBCASE("Projected, assigned, swapped and re-ordered containers invalidate too") {
+        auto proj = c.begin_ascending_order([](int v) { return -v; });
+        c.emplace(7);
+        CHECK_THROWS_AS(*proj, std::logic_error);
+
+        auto before = c.begin_reverse_order();
+        MyContainer<int> other;
+        other.add(9);
+        c = other;
+        CHECK_THROWS_AS(*before, std::logic_error);
+
+        auto mine = c.begin_order(), theirs = other.begin_order();
+        c.swap(other);
+        CHECK_THROWS_AS(*mine, std::logic_error);
+        CHECK_THROWS_AS(*theirs, std::logic_error);
+
+        auto asc = c.begin_ascending_order();
+        c.set_stable_order(true);
+        CHECK_THROWS_AS(*asc, std::logic_error);
+    }
+
+    SUBCASE("Reading, sorting and copying do not invalidate") {
+        auto it = c.begin_middle_out_order();
+        c.begin_descending_order();
+        MyContainer<int> copy(c);
+        c.snapshot();
+        CHECK(c.size() == 4);
+        CHECK(*it == 3);
+    }
+}
+
+/* ════════════════════════════════
+   28. Allocator support – pmr arenas
+   ════════════════════════════════ */
+namespace {
+/// Memory resource that forwards to an upstream resource and counts what passes through.
+class TrackingResource : public std::pmr::memory_resource {
+public:
+    explicit TrackingResource(std::pmr::memory_resource* up = std::pmr::new_delete_resource()) : upstream(up) {}
+    size_t bytes = 0, allocations = 0;
+
+private:
+    std::pmr::memory_resource* upstream;
+
+    void* do_allocate(size_t n, size_t align) override {
+        bytes += n;
+        ++allocations;
+        return upstream->allocate(n, align);
+    }
+    void do_deallocate(void* p, size_t n, size_t align) override { upstream->deallocate(p, n, align); }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+}
+
+TEST_CASE("Allocator parameter routes every buffer through the given allocator") {
+
+    SUBCASE("Elements and the sorted index come from the memory resource") {
+        TrackingResource res;
+        PmrMyContainer<int> c(&res);
+        CHECK(c.get_allocator().resource() == &res);
+        for (int i = 1000; i > 0; --i) c.add(i);
+        size_t before = res.bytes;
+        CHECK(before >= 1000 * sizeof(int));
+        CHECK(*c.begin_ascending_order() == 1);
+        CHECK(res.bytes - before >= 1000 * sizeof(size_t));
+    }
+
+    SUBCASE("Stable views, bulk removal, projections and snapshots use it too") {
+        TrackingResource res;
+        PmrMyContainer<int> c(&res);
+        c.set_stable_order(true);
+        for (int i = 0; i < 300; ++i) c.add(i % 7);
+        auto measure = [&res](auto step) {
+            size_t before = res.allocations;
+            step();
+            return res.allocations - before;
+        };
+        CHECK(measure([&] { c.begin_descending_order(); }) > 0);
+        CHECK(measure([&] { c.remove_all(std::vector<int>{6}); }) > 0);
+        CHECK(measure([&] { c.begin_ascending_order([](int v) { return -v; }); }) > 0);
+        CHECK(measure([&] { c.snapshot(); }) > 0);
+        CHECK(*c.begin_descending_order() == 5);
+    }
+
+    SUBCASE("Stable-sort and merge scratch space comes from the allocator too") {
+        TrackingResource res;
+        auto bytes_for = [&res](auto step) {
+            size_t before = res.bytes;
+            step();
+            return res.bytes - before;
+        };
+        for (unsigned threads : {1u, 4u}) {
+            const size_t n = threads == 1 ? 1000 : 70000;
+            PmrMyContainer<std::string> words(&res);
+            words.set_stable_order(true);
+            words.set_sort_threads(threads);
+            for (size_t i = 0; i < n; ++i) words.add(std::to_string(i % 97));
+            // The index itself, plus the same again as merge scratch.
+            CHECK(bytes_for([&] { words.begin_ascending_order(); }) >= 2 * n * sizeof(size_t));
+            auto length = [](const std::string& w) { return w.size(); };
+            CHECK(bytes_for([&] { words.begin_ascending_order(length); }) >=
+                  2 * n * sizeof(std::pair<size_t, size_t>) + n * sizeof(size_t));
+            CHECK(std::is_sorted(words.begin_ascending_order(), words.end_ascending_order()));
+        }
+    }
+
+    SUBCASE("A monotonic arena with no upstream is enough for a full workload") {
+        std::vector<std::byte> storage(1 << 20);
+        // Unqualified pmr:: must still name std::pmr alongside using namespace ariel.
+        pmr::monotonic_buffer_resource arena(storage.data(), storage.size(),
+                                             pmr::null_memory_resource());
+        {
+            PmrMyContainer<double> c(&arena);
+            c.set_sort_threads(4);
+            for (int i = 0; i < 2000; ++i) c.add((i * 37) % 101 * 0.5);
+            std::vector<double> more{-1.0, 99.0};
+            c.add_range(more.begin(), more.end());
+            CHECK(*c.begin_ascending_order() == -1.0);
+            CHECK(*c.begin_descending_order() == 99.0);
+            CHECK(c.remove_if([](double v) { return v > 40; }) > 0);
+            auto snap = c.snapshot();
+            CHECK(snap.size() == c.size());
+        }
+        arena.release();
+    }
+
+    SUBCASE("Copying into another arena and moving between arenas") {
+        TrackingResource first, second;
+        PmrMyContainer<int> a(&first);
+        for (int v : {3, 1, 2}) a.add(v);
+        auto snap = a.snapshot();
+
+        PmrMyContainer<int> copy(a, &second);
+        CHECK(copy.get_allocator().resource() == &second);
+        CHECK(&copy.snapshot()[0] != &snap[0]);
+        CHECK(std::vector<int>(copy.begin_ascending_order(), copy.end_ascending_order()) ==
+              std::vector<int>{1, 2, 3});
+
+        PmrMyContainer<int> target(&second);
+        target = std::move(a);
+        CHECK(target.get_allocator().resource() == &second);
+        CHECK(target.size() == 3);
+        CHECK(a.size() == 0);
+        CHECK(*target.begin_ascending_order() == 1);
+    }
+
+    SUBCASE("The default allocator keeps the old defaults") {
+        CHECK(std::is_same_v<MyContainer<int>, MyContainer<int, std::less<int>, std::allocator<int>>>);
+        CHECK(std::is_nothrow_move_assignable_v<MyContainer<std::string>>);
+        CHECK_FALSE(std::is_nothrow_move_assignable_v<PmrMyContainer<int>>);
+    }
+}
+
+/* ════════════════════════════════
+   29. Const API – iterating a const MyContainer
+   ════════════════════════════════ */
+namespace {
+template <typename Begin, typename End>
+std::vector<int> collect(Begin begin, End end) { return std::vector<int>(begin, end); }
+}
+
+TEST_CASE("A const MyContainer can be iterated in every order") {
+    MyContainer<int> source;
+    for (int v : {7, 15, 6, 1, 2}) source.add(v);
+    const MyContainer<int>& c = source;
+
+    SUBCASE("All six orders and the projected order work through a const reference") {
+        CHECK(collect(c.begin_order(), c.end_order()) == std::vector<int>{7, 15, 6, 1, 2});
+        CHECK(collect(c.begin_ascending_order(), c.end_ascending_order()) == std::vector<int>{1, 2, 6, 7, 15});
+        CHECK(collect(c.begin_descending_order(), c.end_descending_order()) == std::vector<int>{15, 7, 6, 2, 1});
+        CHECK(collect(c.begin_reverse_order(), c.end_reverse_order()) == std::vector<int>{2, 1, 6, 15, 7});
+        CHECK(collect(c.begin_side_cross_order(), c.end_side_cross_order()) == std::vector<int>{1, 15, 2, 7, 6});
+        CHECK(collect(c.begin_middle_out_order(), c.end_middle_out_order()) == std::vector<int>{6, 15, 1, 7, 2});
+        auto neg = [](int v) { return -v; };
+        CHECK(collect(c.begin_ascending_order(neg), c.end_ascending_order(neg)) == std::vector<int>{15, 7, 6, 2, 1});
+    }
+
+    SUBCASE("cbegin_/cend_ return constant iterators, also on a non-const container") {
+        CHECK(collect(source.cbegin_order(), source.cend_order()) == collect(c.begin_order(), c.end_order()));
+        CHECK(collect(source.cbegin_ascending_order(), source.cend_ascending_order()) == std::vector<int>{1, 2, 6, 7, 15});
+        CHECK(collect(c.cbegin_descending_order(), c.cend_descending_order()) == std::vector<int>{15, 7, 6, 2, 1});
+        CHECK(collect(c.cbegin_reverse_order(), c.cend_reverse_order()) == std::vector<int>{2, 1, 6, 15, 7});
+        CHECK(collect(c.cbegin_side_cross_order(), c.cend_side_cross_order()) == std::vector<int>{1, 15, 2, 7, 6});
+        CHECK(collect(c.cbegin_middle_out_order(), c.cend_middle_out_order()) == std::vector<int>{6, 15, 1, 7, 2});
+        CHECK(std::is_same_v<decltype(*source.cbegin_order()), const int&>);
+        CHECK(std::is_same_v<decltype(source.cbegin_side_cross_order()), decltype(c.begin_side_cross_order())>);
+    }
+
+    SUBCASE("Many threads share one const container, building its views concurrently") {
+        MyContainer<int> big;
+        big.set_stable_order(true);
+        for (int i = 0; i < 20000; ++i) big.add((i * 7919) % 5000);
+        const MyContainer<int>& shared = big;
+        std::atomic<int> wrong{0};
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 8; ++r) {
+            readers.emplace_back([&shared, &wrong, r] {
+                if (r % 2 == 0) {
+                    if (!std::is_sorted(shared.begin_ascending_order(), shared.end_ascending_order())) ++wrong;
+                } else {
+                    auto first = shared.begin_descending_order(), last = shared.end_descending_order();
+                    if (!std::is_sorted(first, last, std::greater<int>())) ++wrong;
+                }
+                if (shared.snapshot().size() != shared.size()) ++wrong;
+                MyContainer<int> copy(shared);
+                if (*copy.begin_ascending_order() != 0) ++wrong;
+            });
+        }
+        for (auto& t : readers) t.join();
+        CHECK(wrong == 0);
+        CHECK(*shared.begin_descending_order() == 4999);
+    }
+}
+
+/* ════════════════════════════════
+   30. Views – ranges over each order
+   ════════════════════════════════ */
+TEST_CASE("Order views work with range-for and std::ranges") {
+    MyContainer<int> c;
+    for (int v : {7, 15, 6, 1, 2}) c.add(v);
+
+    SUBCASE("Range-for over every order") {
+        std::vector<int> seen;
+        for (int v : c.ascending()) seen.push_back(v);
+        CHECK(seen == std::vector<int>{1, 2, 6, 7, 15});
+        seen.clear();
+        for (int v : c.side_cross()) seen.push_back(v);
+        CHECK(seen == std::vector<int>{1, 15, 2, 7, 6});
+        seen.clear();
+        for (int v : c.middle_out()) seen.push_back(v);
+        CHECK(seen == std::vector<int>{6, 15, 1, 7, 2});
+        CHECK(std::vector<int>(c.order().begin(), c.order().end()) == std::vector<int>{7, 15, 6, 1, 2});
+        CHECK(std::vector<int>(c.descending().begin(), c.descending().end()) == std::vector<int>{15, 7, 6, 2, 1});
+        CHECK(std::vector<int>(c.reverse().begin(), c.reverse().end()) == std::vector<int>{2, 1, 6, 15, 7});
+    }
+
+    SUBCASE("Size, subscript, front and back in O(1)") {
+        auto asc = c.ascending();
+        CHECK(asc.size() == 5);
+        CHECK_FALSE(asc.empty());
+        CHECK(asc[2] == 6);
+        CHECK(asc.front() == 1);
+        CHECK(asc.back() == 15);
+        CHECK(MyContainer<int>().ascending().empty());
+    }
+
+    SUBCASE("A projected view sorts once, however often it is traversed") {
+        int calls = 0;
+        auto by_neg = c.ascending([&calls](int v) { ++calls; return -v; });
+        CHECK(calls == 5);
+        std::vector<int> first(by_neg.begin(), by_neg.end()), second(by_neg.begin(), by_neg.end());
+        CHECK(first == std::vector<int>{15, 7, 6, 2, 1});
+        CHECK(first == second);
+        CHECK(calls == 5);
+    }
+
+    SUBCASE("A projected view can be walked backwards") {
+        auto by_neg = c.ascending([](int v) { return -v; });
+        CHECK(by_neg.back() == 1);
+        CHECK(*(by_neg.end() - 2) == 2);
+        std::vector<int> backwards;
+        for (auto it = by_neg.end(); it != by_neg.begin();) backwards.push_back(*--it);
+        CHECK(backwards == std::vector<int>{1, 2, 6, 7, 15});
+#ifdef __cpp_lib_ranges
+        std::vector<int> reversed;
+        for (int v : by_neg | std::views::reverse) reversed.push_back(v);
+        CHECK(reversed == backwards);
+#endif
+    }
+
+#ifdef __cpp_lib_ranges
+    SUBCASE("Views model random_access_range, view and borrowed_range") {
+        using Asc = decltype(c.ascending());
+        CHECK(std::ranges::random_access_range<Asc>);
+        CHECK(std::ranges::sized_range<Asc>);
+        CHECK(std::ranges::view<Asc>);
+        CHECK(std::ranges::borrowed_range<Asc>);
+        CHECK(std::random_access_iterator<decltype(c.side_cross().begin())>);
+        CHECK(std::ranges::random_access_range<decltype(c.middle_out())>);
+        CHECK(std::ranges::random_access_range<decltype(c.ascending([](int v) { return v; }))>);
+    }
+
+    SUBCASE("Views compose with std::views pipelines") {
+        std::vector<int> small_even;
+        for (int v : c.ascending() | std::views::filter([](int v) { return v % 2 == 0; }) | std::views::take(2))
+            small_even.push_back(v);
+        CHECK(small_even == std::vector<int>{2, 6});
+
+        auto top = c.descending() | std::views::take(3);
+        CHECK(std::ranges::size(top) == 3);
+        CHECK(std::vector<int>(top.begin(), top.end()) == std::vector<int>{15, 7, 6});
+
+        auto found = std::ranges::find(c.side_cross(), 7);
+        CHECK(found - c.begin_side_cross_order() == 3);
+        CHECK(std::ranges::distance(c.middle_out() | std::views::drop(1)) == 4);
+    }
+#endif
+}
+
+/* ════════════════════════════════
+   31. Top-k – smallest(k) / largest(k)
+   ════════════════════════════════ */
+TEST_CASE("smallest(k) and largest(k) select without a full sort") {
+
+    SUBCASE("They match the first k of the full views") {
+        MyContainer<int> c;
+        for (int i = 0; i < 1000; ++i) c.add((i * 7919) % 613);
+        MyContainer<int> fresh(c);
+        auto small = fresh.smallest(10);
+        auto large = fresh.largest(10);
+        std::vector<int> asc(c.begin_ascending_order(), c.begin_ascending_order() + 10);
+        std::vector<int> desc(c.begin_descending_order(), c.begin_descending_order() + 10);
+        CHECK(std::vector<int>(small.begin(), small.end()) == asc);
+        CHECK(std::vector<int>(large.begin(), large.end()) == desc);
+        CHECK(small.size() == 10);
+        CHECK(large.front() == 612);
+    }
+
+    SUBCASE("k of zero, and k past the end, are clamped") {
+        MyContainer<int> c;
+        for (int v : {3, 1, 2}) c.add(v);
+        CHECK(c.smallest(0).empty());
+        auto all = c.largest(50);
+        CHECK(std::vector<int>(all.begin(), all.end()) == std::vector<int>{3, 2, 1});
+        CHECK(MyContainer<int>().smallest(5).empty());
+    }
+
+    SUBCASE("Stable mode keeps insertion order among ties, as the full views do") {
+        MyContainer<Employee, ByAge> staff;
+        staff.set_stable_order(true);
+        staff.add({"ann", 30, 1}); staff.add({"bob", 20, 2}); staff.add({"cid", 30, 3});
+        staff.add({"dan", 20, 4}); staff.add({"eve", 40, 5});
+        auto names = [](auto view) {
+            std::vector<std::string> out;
+            for (const Employee& e : view) out.push_back(e.name);
+            return out;
+        };
+        CHECK(names(staff.smallest(3)) == std::vector<std::string>{"bob", "dan", "ann"});
+        CHECK(names(staff.largest(3)) == std::vector<std::string>{"eve", "ann", "cid"});
+        staff.begin_ascending_order();
+        CHECK(names(staff.smallest(3)) == std::vector<std::string>{"bob", "dan", "ann"});
+        CHECK(names(staff.largest(3)) == std::vector<std::string>{"eve", "ann", "cid"});
+    }
+
+    SUBCASE("Selection takes O(n + k log k) comparisons, a cached index O(k) copies") {
+        size_t calls = 0;
+        MyContainer<int, CountingLess> c(CountingLess{&calls});
+        const int n = 100000;
+        for (long long i = 0; i < n; ++i) c.add(static_cast<int>((i * 48271) % n));
+        calls = 0;
+        auto top = c.largest(10);
+        CHECK(top[0] == n - 1);
+        CHECK(top[9] == n - 10);
+        CHECK(calls < static_cast<size_t>(5 * n));
+        size_t selection = calls;
+
+        c.begin_ascending_order();
+        CHECK(calls - selection > static_cast<size_t>(10 * n));
+        calls = 0;
+        auto cached = c.smallest(10);
+        CHECK(calls == 0);
+        CHECK(cached.back() == 9);
+    }
+
+    SUBCASE("A top-k view ends after k elements, also in checked builds") {
+        MyContainer<int> c;
+        for (int i = 0; i < 20; ++i) c.add(i);
+        auto top = c.largest(3);
+        CHECK(top.end() - top.begin() == 3);
+        if (ariel::checked_iterators) {
+            CHECK_THROWS_AS(*top.end(), std::out_of_range);
+            CHECK_THROWS_AS(top.begin() + 4, std::out_of_range);
+            c.add(99);
+            CHECK_THROWS_AS(*top.begin(), std::logic_error);
+        }
+    }
+}
+
+/* ════════════════════════════════
+   32. Lazy sorted traversal – heap first, sort on demand
+   ════════════════════════════════ */
+TEST_CASE("lazy_ascending() and lazy_descending() produce elements on demand") {
+
+    SUBCASE("Full lazy scans equal the eager views") {
+        MyContainer<int> c;
+        for (long long i = 0; i < 5000; ++i) c.add(static_cast<int>((i * 7919) % 997));
+        MyContainer<int> eager(c);
+        auto lazy_up = c.lazy_ascending();
+        auto lazy_down = c.lazy_descending();
+        CHECK(std::vector<int>(lazy_up.begin(), lazy_up.end()) ==
+              std::vector<int>(eager.begin_ascending_order(), eager.end_ascending_order()));
+        CHECK(std::vector<int>(lazy_down.begin(), lazy_down.end()) ==
+              std::vector<int>(eager.begin_descending_order(), eager.end_descending_order()));
+
+        MyContainer<std::string> words;
+        for (const char* w : {"pear", "fig", "apple", "kiwi", "date"}) words.add(w);
+        std::vector<std::string> seen;
+        for (const std::string& w : words.lazy_ascending()) seen.push_back(w);
+        CHECK(seen == std::vector<std::string>{"apple", "date", "fig", "kiwi", "pear"});
+    }
+
+    SUBCASE("A short scan costs O(n + k log n) comparisons, the rest is sorted at the threshold") {
+        size_t calls = 0;
+        MyContainer<int, CountingLess> c(CountingLess{&calls});
+        const int n = 100000;
+        for (long long i = 0; i < n; ++i) c.add(static_cast<int>((i * 48271) % n));
+
+        calls = 0;
+        auto view = c.lazy_descending();
+        std::vector<int> top(view.begin(), view.begin() + 10);
+        CHECK(top.front() == n - 1);
+        CHECK(top.back() == n - 10);
+        CHECK(calls < static_cast<size_t>(3 * n));
+
+        auto it = view.begin() + n / 2;
+        CHECK(*it == n / 2 - 1);
+        size_t after_switch = calls;
+        long long rest = 0;
+        for (; it != view.end(); ++it) rest += *it;
+        CHECK(calls == after_switch);
+        CHECK(rest == static_cast<long long>(n / 2) * (n / 2 - 1) / 2);
+    }
+
+    SUBCASE("sort_fraction moves the switch to a full sort") {
+        size_t calls = 0;
+        MyContainer<int, CountingLess> c(CountingLess{&calls});
+        const int n = 20000;
+        for (long long i = 0; i < n; ++i) c.add(static_cast<int>((i * 48271) % n));
+        auto cost_of_reading = [&](auto view, int k) {
+            calls = 0;
+            CHECK(view[static_cast<size_t>(k)] == k);
+            return calls;
+        };
+        // Position 2000 is past n/16 but not past n/8: only the larger fraction sorts.
+        size_t heap_only = cost_of_reading(c.lazy_ascending(8), 2000);
+        size_t sorted = cost_of_reading(c.lazy_ascending(16), 2000);
+        CHECK(heap_only != sorted);
+        CHECK(cost_of_reading(c.lazy_ascending(0), 0) > cost_of_reading(c.lazy_ascending(), 0));
+
+        auto never = c.lazy_descending(1);
+        std::vector<int> down(never.begin(), never.end());
+        CHECK(down.size() == static_cast<size_t>(n));
+        CHECK(std::is_sorted(down.rbegin(), down.rend()));
+    }
+
+    SUBCASE("Random access may jump ahead and come back") {
+        MyContainer<int> c;
+        for (int i = 99; i >= 0; --i) c.add(i);
+        auto view = c.lazy_ascending();
+        CHECK(view[5] == 5);
+        CHECK(view[2] == 2);
+        CHECK(view.back() == 99);
+        CHECK(view[50] == 50);
+    }
+
+    SUBCASE("Stable mode keeps insertion order among ties") {
+        MyContainer<Employee, ByAge> staff;
+        staff.set_stable_order(true);
+        staff.add({"ann", 30, 1}); staff.add({"bob", 20, 2}); staff.add({"cid", 30, 3});
+        staff.add({"dan", 20, 4}); staff.add({"eve", 40, 5});
+        std::vector<std::string> up, down;
+        for (const Employee& e : staff.lazy_ascending()) up.push_back(e.name);
+        for (const Employee& e : staff.lazy_descending()) down.push_back(e.name);
+        CHECK(up == std::vector<std::string>{"bob", "dan", "ann", "cid", "eve"});
+        CHECK(down == std::vector<std::string>{"eve", "ann", "cid", "bob", "dan"});
+    }
+
+    SUBCASE("A cached ascending index is reused without comparisons") {
+        size_t calls = 0;
+        MyContainer<int, CountingLess> c(CountingLess{&calls});
+        for (int v : {4, 2, 5, 1, 3}) c.add(v);
+        c.begin_ascending_order();
+        calls = 0;
+        auto up = c.lazy_ascending();
+        auto down = c.lazy_descending();
+        CHECK(std::vector<int>(up.begin(), up.end()) == std::vector<int>{1, 2, 3, 4, 5});
+        CHECK(std::vector<int>(down.begin(), down.end()) == std::vector<int>{5, 4, 3, 2, 1});
+        CHECK(calls == 0);
+    }
+
+#ifdef __cpp_lib_ranges
+    SUBCASE("Lazy views are random-access ranges too") {
+        MyContainer<int> c;
+        for (int v : {4, 2, 5, 1, 3}) c.add(v);
+        CHECK(std::ranges::random_access_range<decltype(c.lazy_ascending())>);
+        std::vector<int> two;
+        for (int v : c.lazy_ascending() | std::views::take(2)) two.push_back(v);
+        CHECK(two == std::vector<int>{1, 2});
+    }
+#endif
+}
+
+/* ════════════════════════════════
+   33. Binary save/load and memory-mapped containers
+   ════════════════════════════════ */
+namespace {
+/// A file in the temp directory that is removed when the test is done with it.
+struct TempFile {
+    std::string path;
+    explicit TempFile(const std::string& name)
+        : path((std::filesystem::temp_directory_path() / ("ariel_" + name + ".bin")).string()) {}
+    ~TempFile() { std::filesystem::remove(path); }
+};
+
+struct Point {
+    int x;
+    double y;
+    bool operator<(const Point& other) const { return x < other.x; }
+    bool operator==(const Point& other) const { return x == other.x && y == other.y; }
+};
+ostream& operator<<(ostream& os, const Point& p) { return os << "(" << p.x << "," << p.y << ")"; }
+}
+
+TEST_CASE("save() and load() round-trip a container through a binary file") {
+
+    SUBCASE("Trivially copyable elements keep insertion order and sort again") {
+        TempFile file("ints");
+        MyContainer<int> c;
+        for (int v : {7, 15, 6, 1, 2}) c.add(v);
+        c.save(file.path);
+        CHECK(std::filesystem::file_size(file.path) == sizeof(ariel::SaveHeader) + 5 * sizeof(int));
+
+        MyContainer<int> back;
+        back.add(99);
+        back.begin_ascending_order();
+        back.load(file.path);
+        std::ostringstream oss; oss << back;
+        CHECK(oss.str() == "{7, 15, 6, 1, 2}");
+        CHECK(std::vector<int>(back.begin_ascending_order(), back.end_ascending_order()) ==
+              std::vector<int>{1, 2, 6, 7, 15});
+    }
+
+    SUBCASE("Structs, doubles and empty containers") {
+        TempFile points("points"), empty("empty");
+        MyContainer<Point> c;
+        c.add({3, 0.5}); c.add({1, -2.25});
+        c.save(points.path);
+        MyContainer<Point> back;
+        back.load(points.path);
+        CHECK(back.size() == 2);
+        CHECK(*back.begin_order() == Point{3, 0.5});
+        CHECK(back.begin_ascending_order()->x == 1);
+
+        MyContainer<double>().save(empty.path);
+        MyContainer<double> none;
+        none.add(1.0);
+        none.load(empty.path);
+        CHECK(none.size() == 0);
+    }
+
+    SUBCASE("Strings are length-prefixed, including empty ones and embedded NULs") {
+        TempFile file("strings");
+        MyContainer<std::string> c;
+        c.add("hello"); c.add(""); c.add(std::string("a\0b", 3));
+        c.save(file.path);
+        MyContainer<std::string> back;
+        back.load(file.path);
+        CHECK(back.size() == 3);
+        CHECK(*back.begin_order() == "hello");
+        CHECK((back.begin_order() + 1)->empty());
+        CHECK(back.begin_order()[2] == std::string("a\0b", 3));
+    }
+
+    SUBCASE("Bad files throw runtime_error and leave the container unchanged") {
+        TempFile ints("typed"), junk("junk"), cut("cut");
+        MyContainer<int> c;
+        for (int i = 0; i < 100; ++i) c.add(i);
+        c.save(ints.path);
+
+        MyContainer<double> wrong_type;
+        wrong_type.add(4.5);
+        CHECK_THROWS_AS(wrong_type.load(ints.path), std::runtime_error);
+        CHECK(wrong_type.size() == 1);
+        MyContainer<std::string> wrong_encoding;
+        CHECK_THROWS_AS(wrong_encoding.load(ints.path), std::runtime_error);
+
+        { std::ofstream out(junk.path, std::ios::binary); out << "definitely not a container file"; }
+        CHECK_THROWS_AS(c.load(junk.path), std::runtime_error);
+
+        std::filesystem::copy_file(ints.path, cut.path);
+        std::filesystem::resize_file(cut.path, sizeof(ariel::SaveHeader) + 10);
+        CHECK_THROWS_AS(c.load(cut.path), std::runtime_error);
+        CHECK(c.size() == 100);
+
+        // Huge counts and lengths are rejected before anything is allocated for them.
+        auto patch = [](const std::string& path, std::streamoff at, uint64_t value) {
+            std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+            f.seekp(at);
+            f.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        };
+        const std::streamoff count_at = offsetof(ariel::SaveHeader, count);
+        patch(cut.path, count_at, uint64_t(1) << 60);
+        CHECK_THROWS_AS(c.load(cut.path), std::runtime_error);
+
+        TempFile strings("huge_strings");
+        MyContainer<std::string> words;
+        words.add("alpha"); words.add("beta");
+        words.save(strings.path);
+        patch(strings.path, sizeof(ariel::SaveHeader), uint64_t(1) << 62);
+        CHECK_THROWS_AS(words.load(strings.path), std::runtime_error);
+        words.save(strings.path);
+        patch(strings.path, count_at, uint64_t(1) << 60);
+        CHECK_THROWS_AS(words.load(strings.path), std::runtime_error);
+        words.save(strings.path);
+        patch(strings.path, sizeof(ariel::SaveHeader), 6);  // runs one byte past the end
+        CHECK_THROWS_AS(words.load(strings.path), std::runtime_error);
+        CHECK(words.size() == 2);
+
+        CHECK_THROWS_AS(c.load(ints.path + ".missing"), std::runtime_error);
+        CHECK_THROWS_AS(c.save("/nonexistent-dir/x.bin"), std::runtime_error);
+    }
+}
+
+TEST_CASE("MappedContainer reads a saved file in place") {
+
+    SUBCASE("Elements are read straight from the mapping") {
+        TempFile file("mapped");
+        MyContainer<long long> c;
+        const int n = 100000;
+        for (int i = 0; i < n; ++i) c.add(static_cast<long long>(i) * 3);
+        c.save(file.path);
+
+        MappedContainer<long long> mapped(file.path);
+        CHECK(mapped.size() == static_cast<size_t>(n));
+        CHECK(mapped[0] == 0);
+        CHECK(mapped[n - 1] == 3LL * (n - 1));
+        long long sum = 0;
+        for (long long v : mapped) sum += v;
+        CHECK(sum == 3LL * n * (n - 1) / 2);
+        CHECK(std::is_sorted(mapped.begin(), mapped.end()));
+        if (ariel::checked_iterators) CHECK_THROWS_AS(mapped[n], std::out_of_range);
+    }
+
+    SUBCASE("Moves transfer the mapping; printing matches MyContainer") {
+        TempFile file("moved");
+        MyContainer<int> c;
+        for (int v : {3, 1, 2}) c.add(v);
+        c.save(file.path);
+        MappedContainer<int> first(file.path);
+        MappedContainer<int> second(std::move(first));
+        CHECK(first.empty());
+        CHECK(second.size() == 3);
+        first = std::move(second);
+        std::ostringstream a, b; a << first; b << c;
+        CHECK(a.str() == b.str());
+    }
+
+    SUBCASE("Bad files throw runtime_error") {
+        TempFile file("bad_map");
+        MyContainer<int> c;
+        c.add(1);
+        c.save(file.path);
+        CHECK_THROWS_AS(MappedContainer<double>(file.path), std::runtime_error);
+        CHECK_THROWS_AS(MappedContainer<int>(file.path + ".missing"), std::runtime_error);
+        std::filesystem::resize_file(file.path, 8);
+        CHECK_THROWS_AS(MappedContainer<int>(file.path), std::runtime_error);
+    }
+}